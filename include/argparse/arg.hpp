@@ -23,6 +23,8 @@
 #include "argparse/print.hpp"
 
 #include <array>
+#include <memory_resource>
+#include <new>
 #include <ostream>
 #include <stdexcept>
 #include <string>
@@ -32,11 +34,51 @@
 
 namespace argparse
 {
+	//Type of an arg's data when stored in a slot.  Vectors in slots
+	//allocate from the memory resource given to the slot.
+	template<class T>
+	struct Pooled
+	{
+		typedef T type;
+
+		static void init(void *slot, const T &src, std::pmr::memory_resource*)
+		{ new (slot) T(src); }
+		static void assign(T &dst, const T &src) { dst = src; }
+	};
+
+	template<class T, class A>
+	struct Pooled<std::vector<T, A>>
+	{
+		typedef std::pmr::vector<typename Pooled<T>::type> type;
+
+		static void init(
+			void *slot, const std::vector<T, A> &src,
+			std::pmr::memory_resource *resource)
+		{
+			type tmp(resource);
+			assign(tmp, src);
+			new (slot) type(std::move(tmp));
+		}
+
+		static void assign(type &dst, const std::vector<T, A> &src)
+		{
+			dst.clear();
+			dst.reserve(src.size());
+			for (const T &item : src)
+			{
+				dst.emplace_back();
+				Pooled<T>::assign(dst.back(), item);
+			}
+		}
+	};
+
 	struct ArgCommon
 	{
 		std::vector<const char*> names;
 		const char * const help;
 		bool required;
+		//Dense index assigned by the Parser on registration.
+		std::size_t id;
 
 		ArgCommon() = delete;
 		ArgCommon(const ArgCommon&) = delete;
@@ -56,7 +98,8 @@ namespace argparse
 		):
 			names(names),
 			help(help),
-			required(required)
+			required(required),
+			id(static_cast<std::size_t>(-1))
 		{
 			if (!this->names.size())
 			{ throw std::logic_error("Argument requires at least 1 name."); }
@@ -68,6 +111,36 @@ namespace argparse
 		}
 
 		virtual bool parse(ArgIter &it) = 0;
+		//Number of values taken: N, -1 for variable, -2 for the
+		//remainder, 0 for bool flags.
+		virtual int nargs() const { return 1; }
+		//Apply count consecutive occurrences of a value-less flag at
+		//once.  Return false (without side effects) if unsupported.
+		virtual bool repeat(std::size_t count) { return false; }
+		//Record the current value as the default for reset().
+		virtual void snapshot() {}
+		//Restore the value recorded by snapshot().
+		virtual void reset() {}
+
+		//Per-parse storage.  Args can parse into a separately allocated
+		//slot (see Values) instead of their own data so that parsing
+		//does not modify the args.  slot_size() == 0 means unsupported.
+		virtual std::size_t slot_size() const { return 0; }
+		virtual std::size_t slot_align() const { return 1; }
+		//Construct a slot holding the snapshot() value.  Containers in
+		//the slot allocate from resource.
+		virtual void slot_init(
+			void *slot, std::pmr::memory_resource *resource) const {}
+		//Assign the snapshot() value to a constructed slot.
+		virtual void slot_reset(void *slot) const {}
+		virtual void slot_free(void *slot) const {}
+		virtual bool slot_parse(void *slot, ArgIter &it) const { return false; }
+		virtual bool slot_repeat(void *slot, std::size_t count) const
+		{ return false; }
+
+		//Default for impls that do not support repeat().
+		template<class T>
+		static bool repeat_value(T &value, std::size_t count) { return false; }
 		virtual std::ostream& print_count(std::ostream &o) const = 0;
 		virtual std::ostream& print_acount(std::ostream &o) const
 		{ print_count(o); return o; }
@@ -76,6 +149,10 @@ namespace argparse
 
 	struct FlagCommon: public ArgCommon
 	{
+		//Environment variable read when the flag is not given, see
+		//Parser::env().
+		const char *env = nullptr;
+
 		using ArgCommon::ArgCommon;
 
 		template<class Parser>
@@ -127,8 +204,14 @@ namespace argparse
 			data{}
 		{}
 
+		template<class V>
+		static bool parse_value(V &value, ArgIter &it)
+		{ return argparse::adl_parse(value, it); }
+
 		virtual bool parse(ArgIter &it) override
-		{ return argparse::adl_parse(data, it); }
+		{ return parse_value(data, it); }
+
+		virtual int nargs() const override { return N; }
 
 		virtual std::ostream& print_count(std::ostream &o) const override
 		{
@@ -162,8 +245,14 @@ namespace argparse
 			data(defaults.begin(), defaults.end())
 		{}
 
+		template<class V>
+		static bool parse_value(V &value, ArgIter &it)
+		{ return argparse::adl_parse(value, it); }
+
 		virtual bool parse(ArgIter &it) override
-		{ return argparse::adl_parse(data, it); }
+		{ return parse_value(data, it); }
+
+		virtual int nargs() const override { return -1; }
 
 		virtual std::ostream& print_count(std::ostream &o) const override
 		{
@@ -195,8 +284,12 @@ namespace argparse
 			data(defaults)
 		{}
 
+		template<class V>
+		static bool parse_value(V &value, ArgIter &it)
+		{ return argparse::adl_parse(value, it); }
+
 		virtual bool parse(ArgIter &it) override
-		{ return argparse::adl_parse(data, it); }
+		{ return parse_value(data, it); }
 
 		virtual std::ostream& print_count(std::ostream &o) const override
 		{
@@ -231,12 +324,23 @@ namespace argparse
 			data(defaults)
 		{}
 
-		virtual bool parse(ArgIter &it) override
+		static bool parse_value(bool &value, ArgIter &it)
 		{
-			data = !data;
+			value = !value;
 			return true;
 		}
 
+		static bool repeat_value(bool &value, std::size_t count)
+		{
+			value = value != static_cast<bool>(count & 1);
+			return true;
+		}
+
+		virtual bool parse(ArgIter &it) override
+		{ return parse_value(data, it); }
+
+		virtual int nargs() const override { return 0; }
+
 		virtual std::ostream& print_count(std::ostream &o) const override
 		{
 			o << " !!";
@@ -270,12 +374,23 @@ namespace argparse
 			data(defaults)
 		{}
 
-		virtual bool parse(ArgIter &it) override
+		static bool parse_value(int &value, ArgIter &it)
 		{
-			++data;
+			++value;
 			return true;
 		}
 
+		static bool repeat_value(int &value, std::size_t count)
+		{
+			value += static_cast<int>(count);
+			return true;
+		}
+
+		virtual bool parse(ArgIter &it) override
+		{ return parse_value(data, it); }
+
+		virtual int nargs() const override { return 0; }
+
 		virtual std::ostream& print_count(std::ostream &o) const override
 		 {
 			o << " ++";
@@ -359,9 +474,38 @@ namespace argparse
 	struct Wrapper: public impl
 	{
 		typedef decltype(impl::data) data_type;
+		typedef typename Pooled<data_type>::type slot_type;
+		data_type initial;
 
 		using impl::impl;
 
+		virtual void snapshot() override { initial = this->data; }
+		virtual void reset() override { this->data = initial; }
+
+		virtual bool repeat(std::size_t count) override
+		{ return impl::repeat_value(this->data, count); }
+
+		static slot_type& value(void *slot)
+		{ return *static_cast<slot_type*>(slot); }
+		static const slot_type& value(const void *slot)
+		{ return *static_cast<const slot_type*>(slot); }
+
+		virtual std::size_t slot_size() const override
+		{ return sizeof(slot_type); }
+		virtual std::size_t slot_align() const override
+		{ return alignof(slot_type); }
+		virtual void slot_init(
+			void *slot, std::pmr::memory_resource *resource) const override
+		{ Pooled<data_type>::init(slot, initial, resource); }
+		virtual void slot_reset(void *slot) const override
+		{ Pooled<data_type>::assign(value(slot), initial); }
+		virtual void slot_free(void *slot) const override
+		{ value(slot).~slot_type(); }
+		virtual bool slot_parse(void *slot, ArgIter &it) const override
+		{ return impl::parse_value(value(slot), it); }
+		virtual bool slot_repeat(void *slot, std::size_t count) const override
+		{ return impl::repeat_value(value(slot), count); }
+
 		data_type& operator*() { return this->data; }
 		const data_type& operator*() const { return this->data; }
 
@@ -420,14 +564,34 @@ namespace argparse
 			data(0, nullptr, "")
 		{}
 
-		bool parse(ArgIter &it) override
+		bool parse(ArgIter &it) override { return parse_value(data, it); }
+		int nargs() const override { return -2; }
+
+		void reset() override { data = ArgIter(0, nullptr, ""); }
+
+		static bool parse_value(ArgIter &value, ArgIter &it)
 		{
 			if (it.isflag) { return false; }
-			data = it;
+			value = it;
 			it.finish();
 			return true;
 		}
 
+		static ArgIter& value(void *slot)
+		{ return *static_cast<ArgIter*>(slot); }
+		static const ArgIter& value(const void *slot)
+		{ return *static_cast<const ArgIter*>(slot); }
+
+		std::size_t slot_size() const override { return sizeof(ArgIter); }
+		std::size_t slot_align() const override { return alignof(ArgIter); }
+		void slot_init(void *slot, std::pmr::memory_resource*) const override
+		{ new (slot) ArgIter(0, nullptr, ""); }
+		void slot_reset(void *slot) const override
+		{ value(slot) = ArgIter(0, nullptr, ""); }
+		void slot_free(void *slot) const override { value(slot).~ArgIter(); }
+		bool slot_parse(void *slot, ArgIter &it) const override
+		{ return parse_value(value(slot), it); }
+
 		operator ArgIter&() { return data; }
 		operator const ArgIter&() const { return data; }
 
@@ -462,6 +626,7 @@ namespace argparse
 	struct Aflag: public Flag<T, N>
 	{
 		std::vector<decltype(Flag<T, N>::data)> data;
+		decltype(data) initial;
 		bool clean;
 
 		template<class Parser>
@@ -500,6 +665,76 @@ namespace argparse
 		decltype(data)* operator->() { return &data; }
 		const decltype(data)* operator->() const { return &data; }
 
+		//The wrapped flag is restored too so counts start over.
+		void snapshot() override
+		{
+			Flag<T, N>::snapshot();
+			initial = data;
+		}
+		void reset() override
+		{
+			Flag<T, N>::reset();
+			data = initial;
+			clean = true;
+		}
+
+		//Slots also track whether the defaults were cleared.
+		typedef Pooled<decltype(Aflag::data)> pooled;
+		struct slot_type
+		{
+			typename pooled::type data;
+			bool clean;
+		};
+
+		static typename pooled::type& value(void *slot)
+		{ return static_cast<slot_type*>(slot)->data; }
+		static const typename pooled::type& value(const void *slot)
+		{ return static_cast<const slot_type*>(slot)->data; }
+
+		std::size_t slot_size() const override { return sizeof(slot_type); }
+		std::size_t slot_align() const override { return alignof(slot_type); }
+		void slot_init(
+			void *slot, std::pmr::memory_resource *resource) const override
+		{
+			slot_type s{typename pooled::type(resource), true};
+			pooled::assign(s.data, initial);
+			new (slot) slot_type(std::move(s));
+		}
+		void slot_reset(void *slot) const override
+		{
+			slot_type &s = *static_cast<slot_type*>(slot);
+			pooled::assign(s.data, initial);
+			s.clean = true;
+		}
+		void slot_free(void *slot) const override
+		{ static_cast<slot_type*>(slot)->~slot_type(); }
+		bool slot_parse(void *slot, ArgIter &it) const override
+		{
+			slot_type &s = *static_cast<slot_type*>(slot);
+			if (s.clean)
+			{
+				s.data.clear();
+				s.clean = false;
+			}
+			//Start from the previous occurrence as parse() does with the
+			//wrapped flag's value.
+			if (s.data.empty())
+			{
+				s.data.emplace_back();
+				Pooled<decltype(Flag<T, N>::data)>::assign(
+					s.data.back(), Flag<T, N>::initial);
+			}
+			else
+			{ s.data.push_back(s.data.back()); }
+			if (Flag<T, N>::slot_parse(&s.data.back(), it)) { return true; }
+			s.data.pop_back();
+			return false;
+		}
+		bool slot_repeat(void *slot, std::size_t count) const override
+		{ return false; }
+		//Every occurrence is appended, so runs go through parse().
+		bool repeat(std::size_t count) override { return false; }
+
 		bool parse(ArgIter &it) override
 		{
 			if (clean)
@@ -514,6 +749,7 @@ namespace argparse
 			}
 			return false;
 		}
+
 		std::ostream& print_count(std::ostream &o) const
 		{
 			o << " ...";
@@ -1,42 +1,94 @@
 #ifndef ARGPARSE_ARGITER_HPP
 #define ARGPARSE_ARGITER_HPP
 #include <cstddef>
+#include <memory>
+#include <vector>
 
 namespace argparse
 {
+	struct ResponseFiles;
+	struct Stream;
+
 	struct ArgIter
 	{
 		//> 0 if isflag else not a flag (doesn't start with prefix)
 		std::size_t isflag;
 		const char *arg;
 		private:
+			//Tokens of a response file, NUL separated.
+			struct Source
+			{
+				const char *next;
+				const char *end;
+				//the open ResponseFiles::File
+				const void *file;
+			};
+
 			int argc, pos;
 			const char * const *argv;
+			//tokens come from stream instead of argv if not nullptr
+			Stream *stream;
 			const char *prefix;
 			int forcepos;
+			//current token
+			const char *token;
+			//response files being read, innermost last
+			std::vector<Source> sources;
+			std::shared_ptr<ResponseFiles> files;
+			char filemark;
+
+			//Move to the next token, expanding response files.
+			bool next();
+			bool expand(const char *path);
 		public:
 
 		template<class T, int N>
-		ArgIter(T (&args)[N], const char *prefix="-"):
-			ArgIter(N, args, prefix)
+		ArgIter(T (&args)[N], const char *prefix="-", char filemark='\0'):
+			ArgIter(N, args, prefix, filemark)
 		{}
 
-		ArgIter(int argc, const char * const argv[], const char *prefix="-");
+		//If filemark is not NUL, tokens starting with it name a response
+		//file (ex. @file) whose whitespace separated contents replace it.
+		ArgIter(
+			int argc, const char * const argv[], const char *prefix="-",
+			char filemark='\0');
+
+		//Read tokens from stream.  Tokens are valid until the argument
+		//consuming them returns and the iterator cannot be rewound:
+		//copies share the stream so only one of them can be stepped.  The
+		//stream has no length limit, indices stop at INT_MAX - 1.
+		ArgIter(
+			Stream &stream, const char *prefix="-", char filemark='\0');
 
 		operator bool() const { return pos < argc; }
-		void finish() { pos = argc; }
+		//index of the current token, or of the response file it is from
+		int index() const { return pos; }
+		void finish()
+		{
+			pos = argc;
+			sources.clear();
+		}
+		//Go back to the first token.  Not for streams.
 		void reset();
+		//The iterator can be copied and restored to go back.
+		bool rewindable() const { return !stream; }
+		//Reading the stream failed, see Stream::error().
+		bool failed() const;
+		//Keeps the response files alive, nullptr if none were read.
+		std::shared_ptr<const void> storage() const { return files; }
 		bool isarg() const;
 		bool breakpoint() const;
+		//arg is at the start of the current token
+		bool atstart() const;
 		//name of flag without prefix chars
 
 		void stepbreak();
 
 		//Assume the current arg is a short flag (isflag == 1).
-		//Step through the current short-flag position
+		//Step through count short-flag positions
 		//If the current arg is exhausted, then step
 		//to the next arg.
-		void stepflag();
+		void stepflag(std::size_t count=1);
 
 		//step to the next arg.
 		void step();
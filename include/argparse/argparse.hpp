@@ -2,18 +2,35 @@
 #define ARGPARSE_HPP
 #include "argparse/arg.hpp"
 #include "argparse/argiter.hpp"
+#include "argparse/bitset.hpp"
+#include "argparse/bktree.hpp"
+#include "argparse/mapped.hpp"
 #include "argparse/print.hpp"
+#include "argparse/stream.hpp"
+#include "argparse/table.hpp"
+#include "argparse/trie.hpp"
 
 #include <cstring>
 #include <iostream>
+#include <cstddef>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace argparse
 {
+	struct ConfigFile;
 	struct Group;
 	struct Parser;
+	struct Values;
+	struct Batch;
+	struct Subcommand;
 
 	struct ParseResult
 	{
@@ -26,15 +43,84 @@ namespace argparse
 			error = 4
 		};
 
+		//Details of a failed parse.  Nothing is formatted unless
+		//message() or operator<< is used.
+		struct Error
+		{
+			enum kinds: int
+			{
+				none,
+				unknown_flag,
+				bad_flag,
+				unknown_arg,
+				bad_positional,
+				missing_positional,
+				missing_flag,
+				ambiguous_flag,
+				bad_environment,
+				bad_config,
+				bad_stream
+			};
+			int kind = none;
+			//Index of the offending token in the parsed args, -1 for
+			//missing args.  For config files, the line number (0 if the
+			//file could not be read).
+			int index = 0;
+			//Offending name without prefix.  Points into the parsed args
+			//except for bad/missing args and bad flags read from a stream
+			//where it is the arg's name, bad environment variables where
+			//it is the variable's name and config files where it is the
+			//file's path.  nullptr for stream read errors.
+			const char *name = nullptr;
+			std::size_t size = 0;
+			//Number of prefix chars before name in the message.
+			std::size_t dashes = 0;
+			char prefix = '\0';
+			//The arg involved, nullptr for unknown flags and args.
+			const ArgCommon *arg = nullptr;
+			//Number of values arg takes, see ArgCommon::nargs().
+			int expected = 0;
+			//Closest long flag names to an unknown long flag, closest
+			//first.  Unused entries are nullptr.
+			static constexpr std::size_t maxsuggestions = 3;
+			const char *suggestions[maxsuggestions] = {};
+
+			std::string message() const;
+		};
+
 		int code;
-		std::set<const ArgCommon*> args;
+		//Bits indexed by ArgCommon::id.
+		BitSet args;
 		const Parser *parent;
+		//kind is none unless code is missing, unknown, or error.
+		Error failure;
+		//The subcommand that parsed the rest of the args, if any.
+		std::shared_ptr<Subcommand> subcommand;
+		//Response files, copies of environment variables and the
+		//config file read during the parse.  Parsed strings may point
+		//into them.
+		std::shared_ptr<const void> storage;
+		//Bits of the args parsed from environment variables.
+		BitSet envargs;
+		//Bits of the args parsed from the config file.
+		BitSet configargs;
 		operator bool() const { return code; }
 
-		bool parsed(const ArgCommon &arg) const
-		{ return args.find(&arg) != args.end(); }
+		//Where a value came from, see parsed().
+		enum sources: int
+		{
+			unparsed = 0,
+			commandline = 1,
+			environment = 2,
+			configfile = 3
+		};
+		//Return the source of arg's value, unparsed (false) if it was
+		//not parsed.
+		int parsed(const ArgCommon &arg) const;
 	};
 
+	std::ostream& operator<<(std::ostream &o, const ParseResult::Error &error);
+
 
 	struct Parser
 	{
@@ -44,65 +130,423 @@ namespace argparse
 			{ return std::strcmp(a, b) < 0; }
 		};
 
+		//All args indexed by id.
+		std::vector<ArgCommon*> args;
 		std::vector<ArgCommon*> pos;
 		std::vector<Group*> groups;
 		std::map<const char*, FlagCommon*, Cmp> flags;
+		//Builds the parser of a subcommand when it is used.
+		typedef std::function<std::unique_ptr<Parser>()> Factory;
+		struct Command
+		{
+			const char *help;
+			Factory factory;
+		};
+		std::map<const char*, Command, Cmp> commands;
+		//Single-char flag names indexed by byte value.
+		FlagCommon *shortflags[256];
 		const char *description;
 		const char prefix[2];
 		std::ostream &out;
+		//Look for -h/--help during the main pass instead of scanning
+		//all args beforehand.  Help still wins over errors: the args
+		//after a failure are scanned for a help flag before reporting.
+		bool singlepass;
+		//Do not print error messages, they are still available from
+		//ParseResult::failure.
+		bool quiet;
+		//Accept unambiguous prefixes of long flag names (--verb for
+		//--verbose).
+		bool abbreviate;
+		//Replace @file args with the whitespace separated args in file.
+		//Quotes and backslashes work as in a shell.
+		bool responsefiles;
+		//Path of a file of "name = value" lines giving flags that are
+		//not in the args or environment, nullptr for none.
+		const char *config;
 
 		Parser(
 			const char *description=nullptr, char prefix='-',
 			std::ostream &out=std::cerr);
+		//Subcommand parsers are derived classes owned through Parser.
+		virtual ~Parser() = default;
 
 		void add(ArgCommon &arg);
 		void add(FlagCommon &arg);
 
+		//Add a subcommand.  A token naming a command after all the
+		//positional args constructs the command's parser with factory
+		//and hands it the rest of the args.  Parsers with subcommands
+		//always parse in a single pass (see singlepass) so help flags
+		//after the command go to the subcommand.  The subcommand prints
+		//to this parser's out, not its own.  Parsing throws
+		//std::logic_error if factory returns nullptr.
+		void subcommand(const char *name, const char *help, Factory factory);
+
+		//Parse flag from the environment variable name when it is not
+		//given in the args.  Variables are matched in a single pass
+		//over the environment after the args are parsed.
+		void env(FlagCommon &flag, const char *name);
+
+		//Subcommand whose parser is a default-constructed P.
+		template<class P>
+		void subcommand(const char *name, const char *help=nullptr)
+		{ subcommand(name, help, []() { return std::unique_ptr<Parser>(new P()); }); }
+
+		//Build the lookup tables for parsing and render the help text.
+		//This is done automatically by parse() if any args were added
+		//since the last freeze.  Call it explicitly before sharing a
+		//Parser between threads.
+		void freeze() const;
+
+		//Restore all args to their values at the time they were first
+		//frozen so the parser can be reused for another parse.
+		void reset() const;
+
+		//Write the full help, or only the usage line, to o.  Does not
+		//modify a frozen parser.
+		void help(std::ostream &o, const char *program, bool full=true) const;
+
 		ParseResult parse(int argc, char *argv[]) const
 		{ return parse(argc-1, argv+1, argv[0]); }
 
 		template<class T>
 		ParseResult parse(int argc, T *argv, const char *program) const
 		{
-			ArgIter it(argc, argv, prefix);
+			ArgIter it(argc, argv, prefix, filemark());
 			return parse(it, program);
 		}
 
 		template<class T, int N>
 		ParseResult parse(T (&argv)[N], const char *program) const
 		{
-			ArgIter it(argv, prefix);
+			ArgIter it(argv, prefix, filemark());
+			return parse(it, program);
+		}
+
+		//Parse tokens read from stream, always in a single pass.  A
+		//read error fails with error and bad_stream unless the args
+		//read before it already failed.
+		ParseResult parse(Stream &stream, const char *program) const
+		{
+			ArgIter it(stream, prefix, filemark());
 			return parse(it, program);
 		}
 
 		ParseResult parse(ArgIter &it, const char *program) const;
 
+		//Parse into values instead of the args themselves.  The parser
+		//and its args are not modified, so a frozen parser can be used
+		//by several threads at once, each with its own Values.  Nothing
+		//is written to out: failures are only reported through the
+		//result, and help() writes the help text.
+		template<class T>
+		ParseResult parse(
+			int argc, T *argv, Values &values, const char *program) const
+		{
+			ArgIter it(argc, argv, prefix, filemark());
+			return parse(it, values, program);
+		}
+
+		template<class T, int N>
+		ParseResult parse(
+			T (&argv)[N], Values &values, const char *program) const
+		{
+			ArgIter it(argv, prefix, filemark());
+			return parse(it, values, program);
+		}
+
+		ParseResult parse(
+			ArgIter &it, Values &values, const char *program) const;
+
+		//Parse many argument vectors (without program names) on a pool
+		//of threads into columns of values.  Nothing is printed.
+		//threads=0 uses std::thread::hardware_concurrency().
+		Batch parse_batch(
+			const std::vector<const char*> *rows, std::size_t count,
+			unsigned threads=0) const;
+
+		Batch parse_batch(
+			const std::vector<std::vector<const char*>> &rows,
+			unsigned threads=0) const;
+
 		private:
+			friend struct Values;
+			friend struct Batch;
+
+			char filemark() const { return responsefiles ? '@' : '\0'; }
+
+			//State of a single parse() call.
+			struct Frame
+			{
+				ParseResult result;
+				//Values slots by arg id, nullptr to parse into the args.
+				void * const *slots;
+				const char *program;
+				//Do not print help or errors.
+				bool silent;
+				//Do not print errors: silent, this parser or a parent
+				//parser is quiet.
+				bool mute;
+				//Where help and errors go, the top level parser's out.
+				std::ostream &out;
+				decltype(pos)::const_iterator posit;
+				//Copies of multi-value environment variables.
+				std::shared_ptr<std::deque<std::string>> envcopies;
+				//Tokens of each copy, kept for remainder flags.
+				std::shared_ptr<std::deque<std::vector<const char*>>> envvalues;
+				std::shared_ptr<const ConfigFile> configfile;
+			};
+
+			mutable bool frozen;
+			mutable NameTable table;
+			mutable std::vector<FlagCommon*> tableflags;
+			//flag names to the flag's id
+			mutable PrefixTrie prefixes;
+			//long flag names for suggestions
+			mutable BKTree nearnames;
+			mutable NameTable commandtable;
+			mutable std::vector<decltype(commands)::const_pointer> tablecommands;
+			mutable BitSet requiredflags;
+			//environment variable names to flags
+			mutable NameTable envtable;
+			mutable std::vector<FlagCommon*> envflags;
+			//number of args with a snapshot
+			mutable std::size_t snapped;
+			//Values layout, offsets are npos if unsupported by the arg.
+			mutable std::vector<std::size_t> slotoffsets;
+			mutable std::size_t slotbytes;
+			//Help text rendered by freeze().  Full help is
+			//helpnotes, "Usage: ", program, usage, helpbody.
+			mutable std::string helpnotes;
+			mutable std::string usage;
+			mutable std::string helpbody;
+			//config read by the last parse, reused until the path or the
+			//file's inode, size, mtime or ctime change, always reread where
+			//stat times are not precise.  Dropped by freeze().
+			mutable std::shared_ptr<const ConfigFile> configcache;
+			mutable std::mutex configlock;
+
+			FlagCommon* findflag(const char *name) const
+			{
+				std::size_t idx = table.find(name);
+				return idx == table.npos ? nullptr : tableflags[idx];
+			}
+
 			//Search for full help flag. Return true if found or not.
-			bool prehelp(ArgIter &it, const char *program) const;
+			bool prehelp(ArgIter &it, const Frame &frame) const;
+			//Search the remaining args for a help flag and print it.
+			bool findhelp(ArgIter &it, const Frame &frame) const;
+
+			//Set the error and code of a failed parse.
+			int fail(
+				Frame &frame, int code, int kind, int index,
+				const char *name, std::size_t size, std::size_t dashes,
+				const ArgCommon *arg) const;
+
+			//mute: do not print errors (a parent parser is quiet).
+			ParseResult run(
+				ArgIter &it, void * const *slots, const char *program,
+				bool silent, bool mute, std::ostream &to) const;
+
+			bool parsearg(ArgCommon *arg, ArgIter &it, Frame &frame) const
+			{
+				return frame.slots
+					? arg->slot_parse(frame.slots[arg->id], it)
+					: arg->parse(it);
+			}
+
+			bool repeatarg(ArgCommon *arg, std::size_t count, Frame &frame) const
+			{
+				return frame.slots
+					? arg->slot_repeat(frame.slots[arg->id], count)
+					: arg->repeat(count);
+			}
+
+			void render_help() const;
 
-			void do_shorthelp(const char *program) const;
+			void do_shorthelp(const Frame &frame) const;
 
-			void do_fullhelp(const char *program) const;
+			void do_fullhelp(const Frame &frame) const;
 
-			void flaghelp(const ArgCommon *flag, const char *indent) const;
+			void flaghelp(
+				std::ostream &o, const FlagCommon *flag, const char *indent) const;
+			//index is npos unless the arg's name is shared.
 			void arghelp(
-				const ArgCommon *arg, const char *indent,
-				const std::map<const char *, int, Cmp> &count) const;
+				std::ostream &o, const ArgCommon *arg, const char *indent,
+				std::size_t index) const;
 
-			int handle_shortflag(
-				ArgIter &it, ParseResult &result,
-				const char *program) const;
+			int handle_shortflag(ArgIter &it, Frame &frame) const;
 
-			int handle_longflag(ArgIter &it, ParseResult &result) const;
+			int handle_longflag(ArgIter &it, Frame &frame) const;
 
-			int handle_positional(
-				ArgIter &it, ParseResult &result,
-				decltype(pos)::const_iterator &posit) const;
+			int handle_positional(ArgIter &it, Frame &frame) const;
+			//Parse the rest of the args with the subcommand.
+			int handle_subcommand(ArgIter &it, Frame &frame, std::size_t idx) const;
+
+			//Bool/count flags in the environment or config are given
+			//unless the value is empty, 0 or false.
+			static bool given(const char *value)
+			{
+				return value[0] && std::strcmp(value, "0")
+					&& std::strcmp(value, "false");
+			}
+
+			//Parse flags not in the args from the environment.
+			int read_env(Frame &frame) const;
+			//The cached config or config read and split by line.
+			std::shared_ptr<const ConfigFile> load_config() const;
+			//Parse flags not in the args or environment from config.
+			int read_config(Frame &frame) const;
+
+			void check_required(Frame &frame) const;
+	};
+
+	//Per-parse storage of the values of every arg in a Parser.
+	//Values can be reused for many parses.  Each parse starts from the
+	//defaults.  The parser must not have args added while it has Values.
+	//Vectors in the values allocate from resource, which must outlive
+	//the Values (ex. a std::pmr::monotonic_buffer_resource).
+	struct Values
+	{
+		const Parser &parser;
+
+		Values(
+			const Parser &parser,
+			std::pmr::memory_resource *resource=std::pmr::get_default_resource());
+		~Values();
+		Values(const Values&) = delete;
+		Values& operator=(const Values&) = delete;
+
+		//Restore every value to the arg's default.
+		void reset();
+
+		void* slot(const ArgCommon &arg);
+		const void* slot(const ArgCommon &arg) const;
+
+		//The value of arg.  Same type as arg's data except vectors
+		//are std::pmr::vector.
+		template<class A>
+		auto operator[](const A &arg)
+			-> decltype(A::value(static_cast<void*>(nullptr)))
+		{ return A::value(slot(arg)); }
+
+		template<class A>
+		auto operator[](const A &arg) const
+			-> decltype(A::value(static_cast<const void*>(nullptr)))
+		{ return A::value(slot(arg)); }
+
+		private:
+			friend struct Parser;
+			std::unique_ptr<std::max_align_t[]> buffer;
+			std::vector<void*> slots;
+			bool dirty;
+	};
+
+	//A subcommand chosen during a parse.
+	struct Subcommand
+	{
+		const char *name;
+		//program name used for the subcommand's help: "program name"
+		std::string program;
+		std::unique_ptr<Parser> parser;
+		ParseResult result;
+
+		//The parser as the type built by the command's factory.
+		template<class P>
+		P& get() const { return static_cast<P&>(*parser); }
+	};
+
+	inline int ParseResult::parsed(const ArgCommon &arg) const
+	{
+		if (!args.test(arg.id) || parent->args[arg.id] != &arg)
+		{ return unparsed; }
+		if (envargs.test(arg.id)) { return environment; }
+		return configargs.test(arg.id) ? configfile : commandline;
+	}
+
+	//Values of one arg in every row of a Batch.
+	template<class A>
+	struct Column
+	{
+		char *base;
+		std::size_t stride;
+		std::size_t count;
+
+		std::size_t size() const { return count; }
+
+		auto operator[](std::size_t row) const
+			-> decltype(A::value(static_cast<void*>(nullptr)))
+		{ return A::value(base + row * stride); }
+	};
+
+	//Columnar results of Parser::parse_batch().  Each arg has one
+	//contiguous column of values with one value per row.  Vectors in
+	//the values allocate from arenas owned by the Batch.
+	struct Batch
+	{
+		const Parser &parser;
+		//ParseResult code of each row.
+		std::vector<int> codes;
+		//Parsed args of each row, indexed by ArgCommon::id.
+		std::vector<BitSet> args;
+		//Failure of each row, kind is none if the row has no error.
+		std::vector<ParseResult::Error> failures;
+		//Subcommand of each row, if any.
+		std::vector<std::shared_ptr<Subcommand>> subcommands;
+		//Args of each row parsed from environment variables.
+		std::vector<BitSet> envargs;
+		//Args of each row parsed from the config file.
+		std::vector<BitSet> configargs;
+		//Storage of each row, see ParseResult::storage.
+		std::vector<std::shared_ptr<const void>> storage;
+
+		Batch(const Parser &parser, std::size_t rows);
+		Batch(Batch&&) = default;
+		Batch(const Batch&) = delete;
+		Batch& operator=(const Batch&) = delete;
+		~Batch();
+
+		std::size_t size() const { return codes.size(); }
+
+		//Source of arg's value in row, see ParseResult::parsed().
+		int parsed(const ArgCommon &arg, std::size_t row) const
+		{
+			if (!args[row].test(arg.id) || parser.args[arg.id] != &arg)
+			{ return ParseResult::unparsed; }
+			if (envargs[row].test(arg.id)) { return ParseResult::environment; }
+			return configargs[row].test(arg.id)
+				? ParseResult::configfile : ParseResult::commandline;
+		}
+
+		void* slot(const ArgCommon &arg, std::size_t row);
+
+		template<class A>
+		Column<A> column(const A &arg)
+		{
+			check(arg);
+			return {columns[arg.id].get(), strides[arg.id], size()};
+		}
+
+		template<class A>
+		auto operator()(const A &arg, std::size_t row)
+			-> decltype(A::value(static_cast<void*>(nullptr)))
+		{ return A::value(slot(arg, row)); }
+
+		private:
+			friend struct Parser;
+			std::vector<std::unique_ptr<char[]>> columns;
+			std::vector<std::size_t> strides;
+			//one per worker thread
+			std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> arenas;
+			//rows whose values were constructed
+			std::vector<char> live;
 
-			void check_required(
-				ParseResult &result,
-				decltype(pos)::const_iterator &posit) const;
+			void check(const ArgCommon &arg) const;
+			//Construct the values of a row, fill its slots.
+			void init(
+				std::size_t row, void **slots,
+				std::pmr::memory_resource *resource);
 	};
 
 	struct Group
@@ -0,0 +1,86 @@
+// Fixed-size set of bits indexed by argument id.
+//
+// Sets up to local * 64 bits are stored inline so small parsers never
+// allocate.
+#ifndef ARGPARSE_BITSET_HPP
+#define ARGPARSE_BITSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace argparse
+{
+	struct BitSet
+	{
+		typedef std::uint64_t word;
+		static const std::size_t wordbits = 64;
+		static const std::size_t local = 2;
+
+		BitSet(std::size_t size=0):
+			count(0),
+			inwords{}
+		{ resize(size); }
+
+		//Resize and clear all bits.
+		void resize(std::size_t size)
+		{
+			count = size;
+			std::size_t n = nwords();
+			if (n > local) { heap.assign(n, 0); }
+			else
+			{
+				heap.clear();
+				for (std::size_t i=0; i<local; ++i) { inwords[i] = 0; }
+			}
+		}
+
+		std::size_t size() const { return count; }
+		std::size_t nwords() const { return (count + wordbits - 1) / wordbits; }
+
+		word* words() { return count > local * wordbits ? &heap[0] : inwords; }
+		const word* words() const
+		{ return count > local * wordbits ? &heap[0] : inwords; }
+
+		bool test(std::size_t idx) const
+		{ return idx < count && (words()[idx / wordbits] >> (idx % wordbits)) & 1; }
+
+		void set(std::size_t idx)
+		{ words()[idx / wordbits] |= word(1) << (idx % wordbits); }
+
+		void reset(std::size_t idx)
+		{ words()[idx / wordbits] &= ~(word(1) << (idx % wordbits)); }
+
+		void clear()
+		{
+			word *w = words();
+			for (std::size_t i=0, n=nwords(); i<n; ++i) { w[i] = 0; }
+		}
+
+		//All bits set in mask are also set in this.
+		bool contains(const BitSet &mask) const
+		{
+			const word *w = words();
+			const word *m = mask.words();
+			std::size_t n = nwords();
+			std::size_t mn = mask.nwords();
+			for (std::size_t i=0; i<mn; ++i)
+			{ if (m[i] & ~(i < n ? w[i] : 0)) { return false; } }
+			return true;
+		}
+
+		bool any() const
+		{
+			const word *w = words();
+			for (std::size_t i=0, n=nwords(); i<n; ++i)
+			{ if (w[i]) { return true; } }
+			return false;
+		}
+
+		private:
+			std::size_t count;
+			word inwords[local];
+			std::vector<word> heap;
+	};
+}
+#endif //ARGPARSE_BITSET_HPP
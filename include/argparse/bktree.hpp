@@ -0,0 +1,63 @@
+// Nearest name lookup.
+//
+// BKTree indexes a fixed set of names by Levenshtein distance so the
+// names closest to a misspelled one can be found without comparing it
+// against every name.  Each node's children are linked in a list and
+// labelled by their distance to the node, the triangle inequality then
+// prunes every child outside [d - bound, d + bound].
+#ifndef ARGPARSE_BKTREE_HPP
+#define ARGPARSE_BKTREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace argparse
+{
+	struct BKTree
+	{
+		//Build the tree.  names must be unique and outlive the tree.
+		//Names with the same ids[i] are aliases of one thing, only the
+		//closest of them is returned.  Without ids every name is
+		//distinct.
+		void build(
+			const std::vector<const char*> &names,
+			const std::vector<std::size_t> &ids={});
+		void clear();
+
+		std::size_t size() const { return nodes.size(); }
+
+		//Store up to count names within maxdist of name in out, closest
+		//first.  Return the number stored.  Does not allocate unless
+		//count > maxlocal, both names are 64+ chars or the tree is too
+		//bushy for the local search stack.
+		std::size_t nearest(
+			const char *name, std::size_t maxdist,
+			const char **out, std::size_t count) const;
+
+		static std::size_t distance(
+			const char *a, std::size_t asize, const char *b, std::size_t bsize);
+
+		static constexpr std::size_t maxlocal = 8;
+
+		private:
+			static constexpr std::uint32_t none = static_cast<std::uint32_t>(-1);
+			static constexpr std::size_t localstack = 64;
+
+			struct Node
+			{
+				const char *name;
+				std::size_t size;
+				std::size_t id;
+				//distance to the parent
+				std::size_t dist;
+				std::uint32_t child;
+				std::uint32_t sibling;
+			};
+
+			std::vector<Node> nodes;
+			//Largest search stack a query can need.
+			std::size_t pending = 0;
+	};
+}
+#endif //ARGPARSE_BKTREE_HPP
@@ -0,0 +1,37 @@
+// Read-only file contents in writable memory.
+//
+// MappedFile maps a file privately (copy-on-write) so it can be modified
+// in place without touching the file.  When the file cannot be mapped
+// with a spare byte after its contents or is not a regular file (a pipe,
+// /dev/stdin), it is read into a buffer until EOF instead.  Either way
+// data()[size()] is writable.
+#ifndef ARGPARSE_MAPPED_HPP
+#define ARGPARSE_MAPPED_HPP
+
+#include <cstddef>
+#include <memory>
+
+namespace argparse
+{
+	struct MappedFile
+	{
+		//Check operator bool() for success.
+		MappedFile(const char *path);
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		explicit operator bool() const { return ok; }
+		char* data() const { return base; }
+		std::size_t size() const { return count; }
+
+		private:
+			char *base;
+			std::size_t count;
+			//length of the mapping, 0 if read into buffer
+			std::size_t mapped;
+			std::unique_ptr<char[]> buffer;
+			bool ok;
+	};
+}
+#endif //ARGPARSE_MAPPED_HPP
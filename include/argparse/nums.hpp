@@ -8,16 +8,13 @@
 #include <cmath>
 #include <cstdlib>
 #include <cctype>
+#include <type_traits>
 
 namespace argparse
 {
 	inline bool borderval(float val) { return val == HUGE_VALF; }
 	inline bool borderval(double val) { return val == HUGE_VAL; }
 	inline bool borderval(long double val) { return val == HUGE_VALL; }
-	inline bool borderval(long val) { return val == LONG_MAX || val == LONG_MIN; }
-	inline bool borderval(long long val) { return val == LLONG_MAX || val == LLONG_MIN; }
-	inline bool borderval(unsigned long val) { return val == ULONG_MAX; }
-	inline bool borderval(unsigned long long val) { return val == ULLONG_MAX; }
 
 	inline void rawcvt(float &dst, const char *args, char **end, int base)
 	{ dst = std::strtof(args, end); }
@@ -25,14 +22,6 @@ namespace argparse
 	{ dst = std::strtod(args, end); }
 	inline void rawcvt(long double &dst, const char *args, char **end, int base)
 	{ dst =  std::strtold(args, end); }
-	inline void rawcvt(long &dst, const char *args, char **end, int base)
-	{ dst = std::strtol(args, end, base); }
-	inline void rawcvt(long long &dst, const char *args, char **end, int base)
-	{ dst = std::strtoll(args, end, base); }
-	inline void rawcvt(unsigned long &dst, const char *args, char **end, int base)
-	{ dst = std::strtoul(args, end, base); }
-	inline void rawcvt(unsigned long long &dst, const char *args, char **end, int base)
-	{ dst = std::strtoull(args, end, base); }
 
 	template<class T>
 	bool store(T &dst, const char *arg, int base=10)
@@ -50,16 +39,52 @@ namespace argparse
 		return !*end;
 	}
 
+	//float and double are parsed without strtod, independent of the
+	//locale.  Results are correctly rounded (Eisel-Lemire).
+	template<>
+	bool store<float>(float &dst, const char *arg, int base);
+	template<>
+	bool store<double>(double &dst, const char *arg, int base);
+
+	//Integers are parsed without strtol: digits are validated and
+	//accumulated 8 at a time where possible, with the same results as
+	//strtol/strtoul (including base 0 and 0x prefixes).
 #define DECLARE_SPECIALIZATION(T, prefix) \
 	template<> \
 	bool store<prefix T>(prefix T &dst, const char *arg, int base);
 
 	DECLARE_SPECIALIZATION(short, )
 	DECLARE_SPECIALIZATION(int, )
+	DECLARE_SPECIALIZATION(long, )
+	DECLARE_SPECIALIZATION(long long, )
 	DECLARE_SPECIALIZATION(short, unsigned)
 	DECLARE_SPECIALIZATION(int, unsigned)
+	DECLARE_SPECIALIZATION(long, unsigned)
+	DECLARE_SPECIALIZATION(long long, unsigned)
 #undef DECLARE_SPECIALIZATION
 
+	//Integers in a base known at compile time.  Power of 2 bases shift
+	//instead of multiplying.  Base 0 reads like strtol base 0 (0x hex,
+	//another leading 0 octal) and also takes 0o and 0b prefixes.
+	//Instantiated for bases 0, 2, 4, 8, 16 and 32 and the integer types
+	//above.
+	template<int base, class T>
+	bool storeradix(T &dst, const char *arg);
+
+	template<int base>
+	struct fixedradix:
+		std::integral_constant<
+			bool, base == 0 || (base >= 2 && base <= 32 && !(base & (base-1)))>
+	{};
+
+	template<int base, class T>
+	bool storebase(T &dst, const char *arg, std::true_type)
+	{ return storeradix<base>(dst, arg); }
+
+	template<int base, class T>
+	bool storebase(T &dst, const char *arg, std::false_type)
+	{ return store(dst, arg, base); }
+
 	//A base numbase number.
 	template<class T, int numbase>
 	struct Base
@@ -77,6 +102,10 @@ namespace argparse
 
 	template<class T, int base>
 	bool store(Base<T, base> &dst, const char *arg)
-	{ return store(dst.data, arg, base); }
+	{
+		return storebase<base>(
+			dst.data, arg, std::integral_constant<
+				bool, std::is_integral<T>::value && fixedradix<base>::value>());
+	}
 }
 #endif // ARGPARSE_CONVERT_HPP
@@ -14,9 +14,13 @@
 #define ARGPARSE_PARSE_HPP
 
 #include "argparse/nums.hpp"
+#include "argparse/rangelist.hpp"
+#include "argparse/units.hpp"
 #include "argparse/argiter.hpp"
 
 #include <array>
+#include <cstddef>
+#include <type_traits>
 #include <vector>
 #include <utility>
 
@@ -31,11 +35,25 @@ namespace argparse
 		return 1;
 	}
 
-	template<class T>
-	int parse(std::vector<T> &v, ArgIter &it)
+	//Number of values from the current arg up to the next flag or
+	//breakpoint, 0 if it cannot be known without consuming the args.
+	inline std::size_t valuerun(const ArgIter &it)
+	{
+		std::size_t count = 0;
+		if (!it.rewindable()) { return count; }
+		ArgIter peek(it);
+		for (; peek && !peek.breakpoint() && peek.isarg(); peek.step())
+		{ ++count; }
+		return count;
+	}
+
+	//Numbers are stored straight into the vector, which is reserved
+	//once for the whole run of values.
+	template<class T, class A>
+	int parse_items(std::vector<T, A> &v, ArgIter &it, std::true_type)
 	{
 		v.clear();
-		T tmp;
+		v.reserve(valuerun(it));
 		while (it)
 		{
 			if (it.breakpoint())
@@ -43,18 +61,50 @@ namespace argparse
 				it.stepbreak();
 				return 1;
 			}
-			else if (int code = parse(tmp, it))
+			T value;
+			if (!it.isarg() || !store(value, it.arg)) { return 2; }
+			v.push_back(value);
+			it.step();
+		}
+		return 2;
+	}
+
+	//Items are parsed in place so allocator-aware items (nested
+	//std::pmr::vector) use the vector's allocator.
+	template<class T, class A>
+	int parse_items(std::vector<T, A> &v, ArgIter &it, std::false_type)
+	{
+		v.clear();
+		while (it)
+		{
+			if (it.breakpoint())
+			{
+				it.stepbreak();
+				return 1;
+			}
+			v.emplace_back();
+			if (int code = parse(v.back(), it))
 			{
-				v.push_back(std::move(tmp));
 				if (code == 2)
 				{ return 2; }
 			}
 			else
-			{ return 2; }
+			{
+				v.pop_back();
+				return 2;
+			}
 		}
 		return 2;
 	}
 
+	template<class T, class A>
+	int parse(std::vector<T, A> &v, ArgIter &it)
+	{
+		return parse_items(
+			v, it, std::integral_constant<
+				bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>());
+	}
+
 	template<class T>
 	int parse(T &out, ArgIter &it)
 	{
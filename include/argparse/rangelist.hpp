@@ -0,0 +1,121 @@
+// Compact lists of non-negative integers.
+//
+// A RangeList is parsed from comma separated items, each a number (7),
+// an inclusive range (1-1000) or a range with a step (2000-2100:5).
+// Only the ranges are stored, sorted and disjoint, so a membership test
+// is a binary search and values are produced one at a time by
+// iterating.
+#ifndef ARGPARSE_RANGELIST_HPP
+#define ARGPARSE_RANGELIST_HPP
+
+#include "argparse/bitset.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <vector>
+
+namespace argparse
+{
+	struct RangeList
+	{
+		typedef unsigned long long value_type;
+
+		//first, first+step, ... last.  last is a value in the range and
+		//step is 1 if first == last.
+		struct Range
+		{
+			value_type first;
+			value_type last;
+			value_type step;
+		};
+
+		struct iterator
+		{
+			typedef std::forward_iterator_tag iterator_category;
+			typedef RangeList::value_type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const value_type* pointer;
+			typedef const value_type& reference;
+
+			iterator(): range(nullptr), stop(nullptr), value(0) {}
+			iterator(const Range *range, const Range *stop):
+				range(range),
+				stop(stop),
+				value(range != stop ? range->first : 0)
+			{}
+
+			reference operator*() const { return value; }
+			pointer operator->() const { return &value; }
+
+			iterator& operator++()
+			{
+				if (value == range->last)
+				{
+					++range;
+					value = range != stop ? range->first : 0;
+				}
+				else
+				{ value += range->step; }
+				return *this;
+			}
+			iterator operator++(int)
+			{
+				iterator ret(*this);
+				++*this;
+				return ret;
+			}
+
+			bool operator==(const iterator &o) const
+			{ return range == o.range && value == o.value; }
+			bool operator!=(const iterator &o) const { return !(*this == o); }
+
+			private:
+				const Range *range;
+				const Range *stop;
+				value_type value;
+		};
+		typedef iterator const_iterator;
+
+		RangeList() = default;
+		//Parse spec as store() would.  Throws std::logic_error if it is
+		//not a valid range list or cannot be merged (for defaults given
+		//in code).
+		explicit RangeList(const char *spec);
+
+		iterator begin() const
+		{ return iterator(ranges.data(), ranges.data() + ranges.size()); }
+		iterator end() const
+		{
+			const Range *stop = ranges.data() + ranges.size();
+			return iterator(stop, stop);
+		}
+
+		bool empty() const { return ranges.empty(); }
+		//Number of values, saturating.
+		value_type count() const;
+		bool contains(value_type value) const;
+		const std::vector<Range>& intervals() const { return ranges; }
+
+		//Set the bits of the values, sized to the largest value + 1.
+		//False (bits untouched) if a value is >= limit.
+		bool bitmask(BitSet &bits, std::size_t limit=1<<16) const;
+
+		//Replace the ranges.  Overlapping ranges are merged.  Where two
+		//ranges interleave without one step dividing the other on the
+		//same grid (0-9:2,0-9:3) their values are listed one by one.
+		//False if that would list too many (over 65536 for one overlap).
+		bool assign(std::vector<Range> ranges);
+
+		private:
+			std::vector<Range> ranges;
+	};
+
+	//Leading and trailing whitespace is allowed as for numbers, but not
+	//around the items.  Ranges must not be empty (1-0) or have step 0.
+	bool store(RangeList &dst, const char *arg);
+
+	//Canonical form: 1-1000000,2000-2100:5
+	std::ostream& operator<<(std::ostream &o, const RangeList &list);
+}
+#endif //ARGPARSE_RANGELIST_HPP
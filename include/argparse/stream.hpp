@@ -0,0 +1,54 @@
+// Tokens read from a file descriptor or FILE*.
+//
+// Stream splits its input on a separator ('\0' as from find -print0,
+// or '\n') and hands out one NUL-terminated token at a time from a
+// fixed buffer, so any amount of input is read in constant memory.  The
+// buffer only grows to fit a single token larger than it.  Unread input
+// is moved to a second buffer so the previous token is not overwritten
+// while the next one is read.
+#ifndef ARGPARSE_STREAM_HPP
+#define ARGPARSE_STREAM_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace argparse
+{
+	struct Stream
+	{
+		static constexpr std::size_t defaultcapacity = 1 << 16;
+
+		Stream(
+			int fd, char separator='\0',
+			std::size_t capacity=defaultcapacity);
+		Stream(
+			std::FILE *file, char separator='\0',
+			std::size_t capacity=defaultcapacity);
+
+		//Return the next token or nullptr at the end of the input.  The
+		//returned token is valid until the argument consuming it returns:
+		//it is kept through the next call and overwritten by the one
+		//after it.
+		const char* next();
+		//Reading failed.  The input ended early at the failure.
+		bool error() const { return failed; }
+
+		private:
+			int fd;
+			std::FILE *file;
+			char separator;
+			//unread input is [begin, end), buffer.back() is spare for a
+			//final NUL
+			std::vector<char> buffer;
+			//the buffer before the last move, holds the previous token
+			std::vector<char> spare;
+			std::size_t begin, end;
+			bool eof;
+			bool failed;
+
+			//Read more input after end.
+			void fill();
+	};
+}
+#endif //ARGPARSE_STREAM_HPP
@@ -0,0 +1,52 @@
+// Frozen name lookup.
+//
+// NameTable maps a fixed set of unique names to their index in the
+// vector it was built from.  The table is a collision-free
+// (hash-and-displace) perfect hash keyed on the length and bytes of the
+// name so a lookup is 2 hash mixes and a single memcmp regardless of
+// the number of names.
+#ifndef ARGPARSE_TABLE_HPP
+#define ARGPARSE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace argparse
+{
+	struct NameTable
+	{
+		static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+		NameTable();
+
+		//Build the table.  names must be unique.
+		void build(const std::vector<const char*> &names);
+		void clear();
+
+		//Return index of name or npos.
+		std::size_t find(const char *name) const;
+		std::size_t find(const char *name, std::size_t size) const;
+
+		std::size_t size() const { return count; }
+
+		private:
+			struct Entry
+			{
+				const char *name;
+				std::size_t size;
+				std::size_t index;
+			};
+
+			std::uint64_t seed;
+			std::size_t count;
+			std::size_t bucketmask;
+			std::size_t slotmask;
+			std::vector<std::uint32_t> displace;
+			std::vector<Entry> slots;
+
+			std::size_t lookup(
+				const char *name, std::size_t size, std::uint64_t hash) const;
+	};
+}
+#endif //ARGPARSE_TABLE_HPP
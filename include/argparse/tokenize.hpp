@@ -0,0 +1,31 @@
+// Split command lines into arguments in place.
+//
+// Quoting follows the POSIX shell: whitespace separates arguments,
+// backslash escapes the next character, single quotes are literal and
+// in double quotes backslash only escapes $ ` " \ and newline.
+// Backslash-newline is removed.  Arguments are unquoted and packed at
+// the start of the buffer, each followed by a NUL, so no memory is
+// allocated.
+#ifndef ARGPARSE_TOKENIZE_HPP
+#define ARGPARSE_TOKENIZE_HPP
+
+#include <cstddef>
+
+namespace argparse
+{
+	//Split [begin, end) where *end must be writable.  NUL counts as
+	//whitespace.  Return the end of the packed arguments or nullptr if
+	//a quote is not closed.
+	char* tokenize(char *begin, char *end);
+
+	//Split the NUL-terminated line and store up to capacity pointers to
+	//the arguments in argv.  Return the number of arguments, which may
+	//be more than capacity (the rest follow argv[capacity-1] in the
+	//line), or -1 if a quote is not closed.
+	int tokenize(char *line, const char **argv, int capacity);
+
+	template<int N>
+	int tokenize(char *line, const char *(&argv)[N])
+	{ return tokenize(line, argv, N); }
+}
+#endif //ARGPARSE_TOKENIZE_HPP
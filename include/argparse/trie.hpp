@@ -0,0 +1,61 @@
+// Prefix lookup.
+//
+// PrefixTrie maps any prefix of a fixed set of names to the value shared
+// by every name starting with that prefix.  It is a radix trie stored
+// as one array of nodes: the children of a node are contiguous and
+// sorted by their first character, and edge labels point into the
+// names themselves, so a lookup is O(length of the prefix).
+#ifndef ARGPARSE_TRIE_HPP
+#define ARGPARSE_TRIE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace argparse
+{
+	struct PrefixTrie
+	{
+		static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+		//Prefix of names with different values.
+		static constexpr std::size_t ambiguous = npos - 1;
+
+		PrefixTrie();
+
+		//Build the trie.  names must be unique and outlive the trie.
+		//values[i] is the value of names[i].
+		void build(
+			const std::vector<const char*> &names,
+			const std::vector<std::size_t> &values);
+		void clear();
+
+		//Return the value shared by all names starting with prefix, npos
+		//if there are none (or prefix is empty) or ambiguous.
+		std::size_t find(const char *prefix) const;
+		std::size_t find(const char *prefix, std::size_t size) const;
+
+		private:
+			struct Node
+			{
+				const char *label;
+				std::size_t size;
+				std::uint32_t first;
+				std::uint32_t count;
+				std::size_t value;
+			};
+
+			struct Item
+			{
+				const char *name;
+				std::size_t size;
+				std::size_t value;
+			};
+
+			std::vector<Node> nodes;
+
+			void fill(
+				std::size_t node, const std::vector<Item> &items,
+				std::size_t lo, std::size_t hi, std::size_t depth);
+	};
+}
+#endif //ARGPARSE_TRIE_HPP
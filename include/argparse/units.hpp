@@ -0,0 +1,54 @@
+// Unit-suffixed numbers.
+//
+// Size is a byte count and Duration a length of time, both written as a
+// whole number followed by a unit (512M, 250ms).  The unit is looked up
+// in a constant table after the digits are read and the value is
+// scaled with overflow checks.  Both print in a canonical form that
+// parses back to the same value.
+#ifndef ARGPARSE_UNITS_HPP
+#define ARGPARSE_UNITS_HPP
+
+#include <chrono>
+#include <ostream>
+
+namespace argparse
+{
+	//Bytes.  Suffixes: none or B for bytes, K, M, G, T, P, E (or k) alone
+	//or followed by iB for powers of 1024 and followed by B for powers
+	//of 1000 (KB = 1000, K = KiB = 1024).
+	struct Size
+	{
+		unsigned long long data;
+		operator unsigned long long&() { return data; }
+		operator const unsigned long long&() const { return data; }
+
+		unsigned long long& operator*() { return data; }
+		const unsigned long long& operator*() const { return data; }
+
+		Size& operator=(unsigned long long v) { data = v; return *this; }
+	};
+
+	//Time.  Suffixes: ns, us, ms, s, m, h, d.  No suffix is seconds.
+	//A leading - makes it negative.
+	struct Duration
+	{
+		std::chrono::nanoseconds data;
+		operator std::chrono::nanoseconds&() { return data; }
+		operator const std::chrono::nanoseconds&() const { return data; }
+
+		std::chrono::nanoseconds& operator*() { return data; }
+		const std::chrono::nanoseconds& operator*() const { return data; }
+
+		Duration& operator=(std::chrono::nanoseconds v) { data = v; return *this; }
+	};
+
+	//Leading and trailing whitespace is allowed as for numbers.
+	bool store(Size &dst, const char *arg);
+	bool store(Duration &dst, const char *arg);
+
+	//Largest binary unit that divides the size (512M), or bytes.
+	std::ostream& operator<<(std::ostream &o, const Size &size);
+	//Largest unit that divides the duration (250ms).
+	std::ostream& operator<<(std::ostream &o, const Duration &duration);
+}
+#endif //ARGPARSE_UNITS_HPP
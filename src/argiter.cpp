@@ -1,35 +1,108 @@
 #include "argparse/argiter.hpp"
+#include "argparse/mapped.hpp"
+#include "argparse/stream.hpp"
+#include "argparse/tokenize.hpp"
 
+#include <climits>
 #include <cstdlib>
 #include <cstring>
+#include <string>
 
 namespace argparse
 {
-	ArgIter::ArgIter(int argc, const char * const argv[], const char *prefix):
+	namespace
+	{
+		//Nested response files deeper than this are left as arguments.
+		//Only reached through different files, cycles stop earlier.
+		const std::size_t maxdepth = 64;
+	}
+
+	//Response files opened by an ArgIter and its copies.  Each file is
+	//mapped and tokenized once.  Files with unclosed quotes are not
+	//used.
+	struct ResponseFiles
+	{
+		struct File
+		{
+			std::string path;
+			MappedFile map;
+			//end of the packed args, nullptr if unusable
+			const char *end;
+
+			File(const char *path):
+				path(path),
+				map(path),
+				end(nullptr)
+			{
+				if (map)
+				{ end = tokenize(map.data(), map.data() + map.size()); }
+			}
+		};
+		std::vector<std::unique_ptr<File>> files;
+
+		const File* open(const char *path)
+		{
+			for (auto &file : files)
+			{ if (file->path == path) { return file->end ? file.get() : nullptr; } }
+			files.emplace_back(new File(path));
+			return files.back()->end ? files.back().get() : nullptr;
+		}
+	};
+
+	ArgIter::ArgIter(
+		int argc, const char * const argv[], const char *prefix,
+		char filemark
+	):
 		isflag(0),
+		arg(nullptr),
 		argc(argc),
 		pos(-1),
 		argv(argv),
+		stream(nullptr),
 		prefix(prefix),
+		forcepos(0),
+		token(nullptr),
+		sources{},
+		files{},
+		filemark(filemark)
+	{ step(); }
+
+	ArgIter::ArgIter(Stream &stream, const char *prefix, char filemark):
+		isflag(0),
 		arg(nullptr),
-		forcepos(0)
+		argc(INT_MAX),
+		pos(-1),
+		argv(nullptr),
+		stream(&stream),
+		prefix(prefix),
+		forcepos(0),
+		token(nullptr),
+		sources{},
+		files{},
+		filemark(filemark)
 	{ step(); }
 
 	void ArgIter::reset()
 	{
 		pos = -1;
 		forcepos = 0;
+		sources.clear();
 		step();
 	}
+	bool ArgIter::failed() const { return stream && stream->error(); }
+
 	bool ArgIter::isarg() const
 	{
 		return (
 			pos < argc
-			&& (!isflag || argv[pos] + isflag < arg));
+			&& (!isflag || token + isflag < arg));
 	}
 
+	bool ArgIter::atstart() const
+	{ return pos < argc && arg == token + (isflag >= 2 ? 2 : isflag); }
+
 	bool ArgIter::breakpoint() const
-	{ return isflag >= 2 && !std::strcmp(argv[pos]+isflag, "0"); }
+	{ return isflag >= 2 && !std::strcmp(token+isflag, "0"); }
 
 	void ArgIter::stepbreak()
 	{
@@ -39,26 +112,74 @@ namespace argparse
 		{ ++arg; }
 	}
 
-	void ArgIter::stepflag()
+	void ArgIter::stepflag(std::size_t count)
 	{
-		++arg;
+		arg += count;
 		if (!arg[0]) { step(); }
 	}
+
+	bool ArgIter::next()
+	{
+		while (true)
+		{
+			if (sources.size())
+			{
+				Source &source = sources.back();
+				if (source.next == source.end)
+				{
+					sources.pop_back();
+					continue;
+				}
+				token = source.next;
+				source.next += std::strlen(token) + 1;
+			}
+			else
+			{
+				//streams end at nullptr, argc only ends the indices
+				if (!stream || pos < argc - 1) { ++pos; }
+				if (pos >= argc) { return false; }
+				token = stream ? stream->next() : argv[pos];
+				if (!token)
+				{
+					pos = argc;
+					return false;
+				}
+			}
+			//forced positional args are never expanded
+			if (!filemark || forcepos || token[0] != filemark || !token[1])
+			{ return true; }
+			if (!expand(token + 1)) { return true; }
+		}
+	}
+
+	bool ArgIter::expand(const char *path)
+	{
+		if (sources.size() >= maxdepth) { return false; }
+		if (!files) { files = std::make_shared<ResponseFiles>(); }
+		auto file = files->open(path);
+		if (!file) { return false; }
+		//A file that includes itself, directly or not, is not expanded
+		//again.
+		for (const Source &source : sources)
+		{ if (source.file == file) { return false; } }
+		sources.push_back(Source{file->map.data(), file->end, file});
+		return true;
+	}
+
 	void ArgIter::step()
 	{
-		++pos;
-		if (pos >= argc) { return; }
+		if (!next()) { return; }
 		if (forcepos)
 		{
-			arg = argv[pos];
+			arg = token;
 			--forcepos;
 			isflag = 0;
 			return;
 		}
-		isflag = std::strspn(argv[pos], prefix);
+		isflag = std::strspn(token, prefix);
 		if (isflag == 2)
 		{
-			const char *remain = argv[pos] + 2;
+			const char *remain = token + 2;
 			if (remain[0])
 			{
 				char *end;
@@ -81,8 +202,8 @@ namespace argparse
 				step();
 			}
 		}
-		else if (isflag == 1 && !argv[pos][isflag])
+		else if (isflag == 1 && !token[isflag])
 		{ isflag = 0; }
-		arg = argv[pos] + (isflag >= 2 ? 2 : isflag);
+		arg = token + (isflag >= 2 ? 2 : isflag);
 	}
 }
@@ -1,11 +1,23 @@
 #include "argparse/argparse.hpp"
+#include "argparse/tokenize.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#ifdef _WIN32
+#include <stdlib.h>
+#define ARGPARSE_ENVIRON _environ
+#else
+extern char **environ;
+#define ARGPARSE_ENVIRON environ
+#endif
+
 namespace argparse
 {
 	namespace
@@ -26,6 +38,35 @@ namespace argparse
 		struct lt { bool operator()(std::size_t a, std::size_t b) { return a < b; } };
 		struct gt { bool operator()(std::size_t a, std::size_t b) { return a > b; } };
 
+		//ParseResult::storage when environment variables were copied.
+		struct Storage
+		{
+			std::shared_ptr<const void> files;
+			std::shared_ptr<std::deque<std::string>> envcopies;
+			std::shared_ptr<std::deque<std::vector<const char*>>> envvalues;
+			std::shared_ptr<const ConfigFile> configfile;
+		};
+
+		//A result with no args parsed yet.
+		ParseResult outcome(int code, const Parser *parent)
+		{ return {code, {}, parent, {}, {}, {}, {}, {}}; }
+
+
+		//The flag's own name matching name[0, size): the same name, or
+		//the first longer one it abbreviates.  For failures whose token
+		//a stream may overwrite.
+		const char* ownname(
+			const FlagCommon *flag, const char *name, std::size_t size)
+		{
+			const char *longer = nullptr;
+			for (const char *own : flag->names)
+			{
+				if (std::strncmp(own, name, size)) { continue; }
+				if (!own[size]) { return own; }
+				if (!longer && size > 1) { longer = own; }
+			}
+			return longer ? longer : flag->names[0];
+		}
 
 		struct Flagname
 		{
@@ -75,9 +116,18 @@ namespace argparse
 		const char *description, char prefix,
 		std::ostream &out
 	):
+		shortflags{},
 		description(description),
 		prefix{prefix, '\0'},
-		out(out)
+		out(out),
+		singlepass(false),
+		quiet(false),
+		abbreviate(false),
+		responsefiles(false),
+		config(nullptr),
+		frozen(false),
+		snapped(0),
+		slotbytes(0)
 	{}
 
 	void Parser::add(ArgCommon &arg)
@@ -89,274 +139,684 @@ namespace argparse
 			throw std::logic_error(
 				"Required positional arg after optional positional arg.");
 		}
+		arg.id = args.size();
+		args.push_back(&arg);
 		pos.push_back(&arg);
+		frozen = false;
 	}
 
 	void Parser::add(FlagCommon &arg)
 	{
-		for (const char *name : arg.names)
+		for (auto name = arg.names.begin(); name != arg.names.end(); ++name)
 		{
-			auto result = flags.insert({name, &arg});
-			if (!result.second)
-			{ throw std::logic_error("Flag already added."); }
+			if (!flags.insert({*name, &arg}).second)
+			{
+				while (name != arg.names.begin())
+				{
+					flags.erase(*--name);
+					if (!(*name)[1])
+					{ shortflags[static_cast<unsigned char>(**name)] = nullptr; }
+				}
+				throw std::logic_error("Flag already added.");
+			}
+			if (!(*name)[1])
+			{ shortflags[static_cast<unsigned char>(**name)] = &arg; }
+		}
+		arg.id = args.size();
+		args.push_back(&arg);
+		frozen = false;
+	}
+
+	void Parser::subcommand(
+		const char *name, const char *help, Factory factory)
+	{
+		if (!name || !name[0])
+		{ throw std::logic_error("Command name should not be null or empty."); }
+		if (!factory)
+		{ throw std::logic_error("Command factory should not be empty."); }
+		if (!commands.insert({name, Command{help, std::move(factory)}}).second)
+		{ throw std::logic_error("Command already added: " + std::string(name)); }
+		frozen = false;
+	}
+
+	void Parser::env(FlagCommon &flag, const char *name)
+	{
+		if (!name || !name[0])
+		{ throw std::logic_error("Env name should not be null or empty."); }
+		for (auto flagpair : flags)
+		{
+			if (
+				flagpair.second != &flag && flagpair.second->env
+				&& !std::strcmp(flagpair.second->env, name))
+			{ throw std::logic_error("Env already used: " + std::string(name)); }
+		}
+		flag.env = name;
+		frozen = false;
+	}
+
+	void Parser::freeze() const
+	{
+		std::vector<const char*> names;
+		tableflags.clear();
+		names.reserve(flags.size());
+		tableflags.reserve(flags.size());
+		for (auto flagpair : flags)
+		{
+			names.push_back(flagpair.first);
+			tableflags.push_back(flagpair.second);
+		}
+		table.build(names);
+		std::vector<std::size_t> ids;
+		ids.reserve(tableflags.size());
+		for (auto flagpt : tableflags) { ids.push_back(flagpt->id); }
+		prefixes.build(names, ids);
+		//Long names only, aliases of a flag are suggested once.
+		std::size_t keep = 0;
+		for (std::size_t i=0; i<names.size(); ++i)
+		{
+			if (names[i][1])
+			{
+				names[keep] = names[i];
+				ids[keep++] = ids[i];
+			}
+		}
+		names.resize(keep);
+		ids.resize(keep);
+		nearnames.build(names, ids);
+		names.clear();
+		tablecommands.clear();
+		for (auto &command : commands)
+		{
+			names.push_back(command.first);
+			tablecommands.push_back(&command);
+		}
+		commandtable.build(names);
+		names.clear();
+		envflags.clear();
+		BitSet seen(args.size());
+		for (auto flagpt : tableflags)
+		{
+			if (flagpt->env && !seen.test(flagpt->id))
+			{
+				seen.set(flagpt->id);
+				//FlagCommon::env may be set without Parser::env().
+				for (const char *name : names)
+				{
+					if (!std::strcmp(name, flagpt->env))
+					{ throw std::logic_error("Env already used: " + std::string(name)); }
+				}
+				names.push_back(flagpt->env);
+				envflags.push_back(flagpt);
+			}
 		}
+		envtable.build(names);
+		{
+			std::lock_guard<std::mutex> guard(configlock);
+			configcache.reset();
+		}
+		requiredflags.resize(args.size());
+		for (auto flagpt : tableflags)
+		{ if (flagpt->required) { requiredflags.set(flagpt->id); } }
+		for (; snapped < args.size(); ++snapped) { args[snapped]->snapshot(); }
+		render_help();
+		slotoffsets.clear();
+		slotbytes = 0;
+		for (ArgCommon *arg : args)
+		{
+			std::size_t size = arg->slot_size();
+			std::size_t align = arg->slot_align();
+			if (!size || alignof(std::max_align_t) % align)
+			{
+				slotoffsets.push_back(static_cast<std::size_t>(-1));
+				continue;
+			}
+			slotbytes = (slotbytes + align - 1) / align * align;
+			slotoffsets.push_back(slotbytes);
+			slotbytes += size;
+		}
+		frozen = true;
+	}
+
+	void Parser::reset() const
+	{
+		if (!frozen) { freeze(); }
+		for (ArgCommon *arg : args) { arg->reset(); }
 	}
 
 	ParseResult Parser::parse(ArgIter &it, const char *program) const
+	{ return run(it, nullptr, program, false, false, out); }
+
+	ParseResult Parser::parse(
+		ArgIter &it, Values &values, const char *program) const
 	{
-		if (prehelp(it, program)) { return {ParseResult::help, {}, this}; }
-		ParseResult result{ParseResult::success, {}, this};
-		auto posit = pos.begin();
-		while (it)
+		if (&values.parser != this || values.slots.size() != args.size())
+		{ throw std::logic_error("Values do not match the parser."); }
+		if (values.dirty) { values.reset(); }
+		values.dirty = true;
+		return run(it, values.slots.data(), program, true, true, out);
+	}
+
+	ParseResult Parser::run(
+		ArgIter &it, void * const *slots, const char *program,
+		bool silent, bool mute, std::ostream &to) const
+	{
+		if (!frozen) { freeze(); }
+		Frame frame{
+			outcome(ParseResult::success, this),
+			slots, program, silent, silent || mute || quiet, to, pos.begin(),
+			nullptr, nullptr, nullptr};
+		bool onepass = singlepass || !commands.empty() || !it.rewindable();
+		if (!onepass && prehelp(it, frame))
+		{ return outcome(ParseResult::help, this); }
+		ParseResult &result = frame.result;
+		result.args.resize(args.size());
+		while (it && !result.code)
 		{
 			if (it.isflag == 1)
-			{ if (handle_shortflag(it, result, program)) { return result; } }
+			{ handle_shortflag(it, frame); }
 			else if (it.isflag && !it.breakpoint())
-			{ if (handle_longflag(it, result)) { return result; } }
+			{ handle_longflag(it, frame); }
 			else
-			{ if (handle_positional(it, result, posit)) { return result; } }
+			{ handle_positional(it, frame); }
+		}
+		if (!result.code && it.failed())
+		{
+			fail(
+				frame, result.error, ParseResult::Error::bad_stream,
+				-1, nullptr, 0, 0, nullptr);
 		}
-		check_required(result, posit);
-		return result;
+		if (!result.code && envflags.size()) { read_env(frame); }
+		if (!result.code && config) { read_config(frame); }
+		if (!result.code) { check_required(frame); }
+		if (frame.envcopies || frame.configfile)
+		{
+			result.storage = std::make_shared<Storage>(
+				Storage{
+					it.storage(), frame.envcopies, frame.envvalues,
+					frame.configfile});
+		}
+		else
+		{ result.storage = it.storage(); }
+		//Subcommands report their own failures.
+		if (
+			!result.code || result.code == result.help
+			|| (result.subcommand && result.subcommand->result.code))
+		{ return std::move(result); }
+		//Stepping a stream would invalidate the failure's name.
+		if (onepass && it.rewindable())
+		{
+			if (!it.atstart()) { it.step(); }
+			if (findhelp(it, frame)) { return outcome(ParseResult::help, this); }
+		}
+		if (!frame.mute) { to << result.failure << std::endl; }
+		return std::move(result);
+	}
+
+	bool Parser::prehelp(ArgIter &it, const Frame &frame) const
+	{
+		ArgIter start(it);
+		if (findhelp(it, frame)) { return true; }
+		it = start;
+		return false;
 	}
 
-	bool Parser::prehelp(ArgIter &it, const char *program) const
+	bool Parser::findhelp(ArgIter &it, const Frame &frame) const
 	{
 		while (it)
 		{
-			if (it.isflag == 2 && !std::strcmp(it.arg, "help") && flags.find("help") == flags.end())
+			if (it.isflag == 2 && !std::strcmp(it.arg, "help") && !findflag("help"))
 			{
-				do_fullhelp(program);
+				if (!frame.silent) { do_fullhelp(frame); }
 				return true;
 			}
-			else if (it.isflag == 1 && !std::strcmp(it.arg, "h") && flags.find("h") == flags.end())
+			else if (it.isflag == 1 && !std::strcmp(it.arg, "h") && !shortflags['h'])
 			{
-				do_shorthelp(program);
+				if (!frame.silent) { do_shorthelp(frame); }
 				return true;
 			}
 			it.step();
 		}
-		it.reset();
 		return false;
 	}
 
-	void Parser::do_shorthelp(const char *program) const
+	int Parser::fail(
+		Frame &frame, int code, int kind, int index,
+		const char *name, std::size_t size, std::size_t dashes,
+		const ArgCommon *arg) const
+	{
+		frame.result.failure = {
+			kind, index, name, size, dashes, prefix[0], arg,
+			arg ? arg->nargs() : 0, {}};
+		return frame.result.code = code;
+	}
+
+	std::string ParseResult::Error::message() const
+	{
+		std::ostringstream o;
+		o << *this;
+		return o.str();
+	}
+
+	std::ostream& operator<<(std::ostream &o, const ParseResult::Error &error)
+	{
+		static const char *messages[] = {
+			"",
+			"Unknown flag \"",
+			"Error parsing flag \"",
+			"Unknown argument \"",
+			"Error parsing positional \"",
+			"Missing required positional argument \"",
+			"Missing required flag \"",
+			"Ambiguous flag \"",
+			"Error parsing environment variable \"",
+			"Error in config file \"",
+			"Error reading the argument stream"
+		};
+		if (error.kind == error.none) { return o; }
+		if (error.kind == error.bad_stream) { return o << messages[error.kind]; }
+		o << messages[error.kind];
+		for (std::size_t i=0; i<error.dashes; ++i) { o << error.prefix; }
+		o.write(error.name, error.size);
+		o << '"';
+		if (error.kind == error.bad_config && error.index > 0)
+		{ o << ", line " << error.index; }
+		if (error.suggestions[0])
+		{
+			o << ", did you mean";
+			for (std::size_t i=0; i<error.maxsuggestions && error.suggestions[i]; ++i)
+			{
+				o << (i ? ", \"" : " \"") << error.prefix << error.prefix
+					<< error.suggestions[i] << '"';
+			}
+			o << '?';
+		}
+		return o;
+	}
+
+	void Parser::render_help() const
 	{
 		const char *wrap[] = {"[]", "<>"};
-		std::set<const FlagCommon*> handled;
-		out << "Usage: " << program;
+		std::ostringstream o;
+		BitSet handled(args.size());
 		for (auto flagpair : flags)
 		{
 			auto flagpt = flagpair.second;
-			if (handled.find(flagpt) != handled.end())
-			{ continue; }
-			handled.insert(flagpt);
-			out << ' ' << wrap[flagpt->required][0]
+			if (handled.test(flagpt->id)) { continue; }
+			handled.set(flagpt->id);
+			o << ' ' << wrap[flagpt->required][0]
 				<< Flagname{prefix, most<lt>(flagpt->names)}
 				<< FlagCount{flagpt} << wrap[flagpt->required][1];
 		}
 		for (auto argpt : pos)
 		{
-			out << ' ' << wrap[argpt->required][0] << argpt->names[0]
+			o << ' ' << wrap[argpt->required][0] << argpt->names[0]
 				<< ArgCount{argpt} << wrap[argpt->required][1];
 		}
-		out << std::endl;
-	}
+		if (commands.size()) { o << " <command> ..."; }
+		o << '\n';
+		usage = o.str();
 
-	void Parser::do_fullhelp(const char *program) const
-	{
-		std::map<const char *, int, Cmp> namecount;
-		for (auto argpt: pos)
+		//Positional index of each arg whose name is shared, else npos.
+		std::vector<std::size_t> posindex(args.size(), NameTable::npos);
+		std::map<const char *, std::size_t, Cmp> firstpos;
+		o.str("");
+		for (std::size_t i=0; i<pos.size(); ++i)
 		{
-			auto result = namecount.insert({argpt->names[0], 1});
+			auto result = firstpos.insert({pos[i]->names[0], i});
 			if (!result.second)
 			{
-				result.first->second += 1;
-				out << "repeated arg: " << argpt->names[0] << std::endl;
+				posindex[pos[result.first->second]->id] = result.first->second;
+				posindex[pos[i]->id] = i;
+				o << "repeated arg: " << pos[i]->names[0] << '\n';
 			}
 		}
+		helpnotes = o.str();
 
-		do_shorthelp(program);
+		o.str("");
 		if (description)
-		{ out << std::endl << description << std::endl; }
-		std::set<ArgCommon*> handled;
+		{ o << '\n' << description << '\n'; }
+		BitSet isflag(args.size());
+		for (auto flagpt : tableflags) { isflag.set(flagpt->id); }
+		handled.clear();
 		for (Group *group: groups)
 		{
-			std::vector<ArgCommon*> groupflags;
-			std::vector<ArgCommon*> grouppos;
+			o << '\n' << group->name << " args:\n";
+			bool header = true;
+			for (ArgCommon *arg : group->members)
+			{
+				if (!isflag.test(arg->id)) { continue; }
+				if (header) { o << "  Flags:\n"; header = false; }
+				flaghelp(o, static_cast<FlagCommon*>(arg), "    ");
+				handled.set(arg->id);
+			}
+			header = true;
 			for (ArgCommon *arg : group->members)
 			{
-				auto it = flags.find(arg->names[0]);
-				if (it == flags.end() || it->second != arg)
-				{ grouppos.push_back(arg); }
-				else
-				{ groupflags.push_back(arg); }
-				handled.insert(arg);
+				if (isflag.test(arg->id)) { continue; }
+				if (header) { o << "  Positional Arguments:\n"; header = false; }
+				arghelp(o, arg, "    ", posindex[arg->id]);
+				handled.set(arg->id);
 			}
-			out << std::endl << group->name << " args:" << std::endl;
-			if (groupflags.size()) { out << "  Flags:" << std::endl; }
-			for (auto &flag : groupflags) { flaghelp(flag, "    "); }
-			if (grouppos.size()) { out << "  Positional Arguments:" << std::endl; }
-			for (auto &arg : grouppos) { arghelp(arg, "    ", namecount); }
 		}
 		bool header = true;
 		for (auto pair: flags)
 		{
-			if (handled.find(pair.second) == handled.end())
+			if (!handled.test(pair.second->id))
 			{
 				if (header)
 				{
-					out << std::endl << "Flags:" << std::endl;
+					o << "\nFlags:\n";
 					header = false;
 				}
-				flaghelp(pair.second, "  ");
-				handled.insert(pair.second);
+				flaghelp(o, pair.second, "  ");
+				handled.set(pair.second->id);
 			}
 		}
 		header = true;
 		for (auto argpt: pos)
 		{
-			if (handled.find(argpt) == handled.end())
+			if (!handled.test(argpt->id))
 			{
 				if (header)
 				{
-					out << std::endl << "Positional Arguments:" << std::endl;
+					o << "\nPositional Arguments:\n";
 					header = false;
 				}
-				arghelp(argpt, "  ", namecount);
-				handled.insert(argpt);
+				arghelp(o, argpt, "  ", posindex[argpt->id]);
+				handled.set(argpt->id);
 			}
 		}
+		if (commands.size()) { o << "\nCommands:\n"; }
+		for (auto &command : commands)
+		{
+			o << "  " << command.first << '\n';
+			if (command.second.help)
+			{ o << "    " << command.second.help << '\n'; }
+		}
+		helpbody = o.str();
 	}
 
-	void Parser::flaghelp(const ArgCommon *flag, const char *indent) const
+	void Parser::help(std::ostream &o, const char *program, bool full) const
+	{
+		if (!frozen) { freeze(); }
+		std::string text;
+		if (full)
+		{
+			text.reserve(
+				helpnotes.size() + usage.size() + helpbody.size()
+				+ std::strlen(program) + 7);
+			text += helpnotes;
+		}
+		text += "Usage: ";
+		text += program;
+		text += usage;
+		if (full) { text += helpbody; }
+		o.write(text.data(), text.size());
+		o.flush();
+	}
+
+	void Parser::do_shorthelp(const Frame &frame) const
+	{ help(frame.out, frame.program, false); }
+
+	void Parser::do_fullhelp(const Frame &frame) const
+	{ help(frame.out, frame.program, true); }
+
+	void Parser::flaghelp(
+		std::ostream &o, const FlagCommon *flag, const char *indent) const
 	{
 		const char *wrap[] = {"[]", "<>"};
 		auto nameit = flag->names.begin();
-		out << indent << wrap[flag->required][0]
+		o << indent << wrap[flag->required][0]
 			<< Flagname{prefix, *nameit++};
 		for (; nameit != flag->names.end(); ++nameit)
-		{ out << " | " << Flagname{prefix, *nameit}; }
-		out << wrap[flag->required][1] << ArgDefaults{flag} << std::endl;
+		{ o << " | " << Flagname{prefix, *nameit}; }
+		o << wrap[flag->required][1] << ArgDefaults{flag};
+		if (flag->env) { o << " Env: " << flag->env; }
+		o << '\n';
 		if (flag->help)
-		{ out << indent << "  " << flag->help << std::endl; }
+		{ o << indent << "  " << flag->help << '\n'; }
 	}
 
 	void Parser::arghelp(
-		const ArgCommon *arg, const char *indent,
-		const std::map<const char *, int, Cmp> &namecount) const
+		std::ostream &o, const ArgCommon *arg, const char *indent,
+		std::size_t index) const
 	{
 		const char *wrap[] = {"[]", "<>"};
-		out << indent << wrap[arg->required][0] << arg->names[0]
+		o << indent << wrap[arg->required][0] << arg->names[0]
 			<< wrap[arg->required][1];
-		if (namecount.at(arg->names[0]) > 1)
+		if (index != NameTable::npos)
+		{ o << " (Positional index " << index << ')'; }
+		o << ArgDefaults{arg} << '\n';
+		if (arg->help) { o << indent << "  " << arg->help << '\n'; }
+	}
+
+	int Parser::handle_shortflag(ArgIter &it, Frame &frame) const
+	{
+		ParseResult &result = frame.result;
+		const char *name = it.arg;
+		FlagCommon *flag = shortflags[static_cast<unsigned char>(name[0])];
+		if (!flag)
 		{
-			for (std::size_t i=0; i<pos.size(); ++i)
+			if (name[0] == 'h' && !name[1])
 			{
-				if (pos[i] == arg)
-				{
-					out << " (Positional index " << i << ')';
-					i = pos.size();
-				}
+				if (!frame.silent) { do_shorthelp(frame); }
+				return result.code = result.help;
+			}
+			return fail(
+				frame, result.unknown, ParseResult::Error::unknown_flag,
+				it.index(), name, 1, 1, nullptr);
+		}
+		int index = it.index();
+		std::size_t run = 1;
+		while (name[run] == name[0]) { ++run; }
+		//Stepping a stream can overwrite name.
+		if (!it.rewindable()) { name = ownname(flag, name, 1); }
+		if (run > 1 && repeatarg(flag, run, frame))
+		{ it.stepflag(run); }
+		else
+		{
+			it.stepflag();
+			if (!parsearg(flag, it, frame))
+			{
+				return fail(
+					frame, result.error, ParseResult::Error::bad_flag,
+					index, name, 1, 1, flag);
 			}
 		}
-		out << ArgDefaults{arg} << std::endl;
-		if (arg->help) { out << indent << "  " << arg->help << std::endl; }
+		result.args.set(flag->id);
+		return 0;
 	}
 
-	int Parser::handle_shortflag(
-		ArgIter &it, ParseResult &result,
-		const char *program) const
+	int Parser::handle_longflag(ArgIter &it, Frame &frame) const
 	{
-		char check[2] = {it.arg[0], '\0'};
-		auto flag = flags.find(check);
-		if (flag == flags.end())
+		ParseResult &result = frame.result;
+		const char *name = it.arg;
+		FlagCommon *flag = findflag(name);
+		//--help is never a prefix of a longer flag.
+		if (!flag && !std::strcmp(name, "help"))
+		{
+			if (!frame.silent) { do_fullhelp(frame); }
+			return result.code = result.help;
+		}
+		if (!flag && abbreviate)
 		{
-			if (check[0] == 'h' && !it.arg[1])
+			std::size_t id = prefixes.find(name);
+			if (id == prefixes.ambiguous)
 			{
-				do_shorthelp(program);
-				return result.code = result.help;
+				return fail(
+					frame, result.unknown, ParseResult::Error::ambiguous_flag,
+					it.index(), name, std::strlen(name), 2, nullptr);
 			}
-			out << "Unknown flag \"" << prefix <<
-				check[0] << '"' << std::endl;
-			return result.code = result.unknown;
+			if (id != prefixes.npos) { flag = static_cast<FlagCommon*>(args[id]); }
+		}
+		if (!flag)
+		{
+			std::size_t size = std::strlen(name);
+			fail(
+				frame, result.unknown, ParseResult::Error::unknown_flag,
+				it.index(), name, size, 2, nullptr);
+			//1 edit for short names, up to 2 for longer ones.
+			nearnames.nearest(
+				name, size < 4 ? 1 : 2, result.failure.suggestions,
+				ParseResult::Error::maxsuggestions);
+			return result.code;
 		}
-		it.stepflag();
-		if (!flag->second->parse(it))
+		int index = it.index();
+		if (!it.rewindable()) { name = ownname(flag, name, std::strlen(name)); }
+		it.step();
+		if (!parsearg(flag, it, frame))
 		{
-			out << "Error parsing flag \"" << prefix
-				<< check[0] << '"' << std::endl;
-			return result.code = result.error;
+			return fail(
+				frame, result.error, ParseResult::Error::bad_flag,
+				index, name, std::strlen(name), 2, flag);
 		}
-		result.args.insert(flag->second);
+		result.args.set(flag->id);
 		return 0;
 	}
 
-	int Parser::handle_longflag(ArgIter &it, ParseResult &result) const
+	int Parser::handle_positional(ArgIter &it, Frame &frame) const
 	{
-		const char *name = it.arg;
-		auto flag = flags.find(name);
-		if (flag == flags.end())
+		ParseResult &result = frame.result;
+		if (frame.posit == pos.end())
 		{
-			out << "Unknown flag \"" << prefix << prefix
-				<< name << '"' << std::endl;
-			return result.code = result.unknown;
+			std::size_t idx = commandtable.find(it.arg);
+			if (idx != commandtable.npos)
+			{ return handle_subcommand(it, frame, idx); }
+			return fail(
+				frame, result.unknown, ParseResult::Error::unknown_arg,
+				it.index(), it.arg, std::strlen(it.arg), 0, nullptr);
 		}
-		it.step();
-		if (!flag->second->parse(it))
+		ArgCommon *arg = *frame.posit;
+		int index = it.index();
+		if (!parsearg(arg, it, frame))
 		{
-			out << "Error parsing flag \"" << prefix << prefix
-				<< name << '"' << std::endl;
-			return result.code = result.error;
+			const char *name = arg->names[0];
+			return fail(
+				frame, result.error, ParseResult::Error::bad_positional,
+				index, name, std::strlen(name), 0, arg);
 		}
-		result.args.insert(flag->second);
+		result.args.set(arg->id);
+		++frame.posit;
 		return 0;
 	}
 
-	int Parser::handle_positional(
-		ArgIter &it, ParseResult &result,
-		decltype(pos)::const_iterator &posit) const
+	int Parser::handle_subcommand(
+		ArgIter &it, Frame &frame, std::size_t idx) const
 	{
-		if (posit == pos.end())
+		ParseResult &result = frame.result;
+		auto command = tablecommands[idx];
+		auto sub = std::make_shared<Subcommand>();
+		sub->name = command->first;
+		if (frame.program)
 		{
-			out << "Unknown argument \"" << it.arg << '"' << std::endl;
-			return result.code = result.unknown;
+			sub->program = frame.program;
+			sub->program += ' ';
 		}
-		if (!(*posit)->parse(it))
+		sub->program += command->first;
+		sub->parser = command->second.factory();
+		if (!sub->parser)
 		{
-			out << "Error parsing positional \""
-				<< (*posit)->names[0] << '"' << std::endl;
-			return result.code = result.error;
+			throw std::logic_error(
+				"Command factory returned null: " + std::string(command->first));
+		}
+		it.step();
+		sub->result = sub->parser->run(
+			it, nullptr, sub->program.c_str(), frame.silent, frame.mute,
+			frame.out);
+		result.code = sub->result.code;
+		result.failure = sub->result.failure;
+		result.subcommand = std::move(sub);
+		return result.code;
+	}
+
+	int Parser::read_env(Frame &frame) const
+	{
+		ParseResult &result = frame.result;
+		result.envargs.resize(args.size());
+		for (char **var = ARGPARSE_ENVIRON; var && *var; ++var)
+		{
+			const char *name = *var;
+			const char *value = std::strchr(name, '=');
+			if (!value) { continue; }
+			std::size_t idx = envtable.find(name, value - name);
+			if (idx == envtable.npos) { continue; }
+			FlagCommon *flag = envflags[idx];
+			//args take priority, the first matching variable is used
+			if (result.args.test(flag->id)) { continue; }
+			++value;
+			bool ok;
+			int nargs = flag->nargs();
+			if (!nargs)
+			{
+				if (!given(value)) { continue; }
+				ArgIter it(0, &value, "");
+				ok = parsearg(flag, it, frame);
+			}
+			else if (nargs == 1)
+			{
+				ArgIter it(1, &value, "");
+				ok = parsearg(flag, it, frame) && !it;
+			}
+			else
+			{
+				//split multiple values like a command line
+				if (!frame.envcopies)
+				{
+					frame.envcopies = std::make_shared<std::deque<std::string>>();
+					frame.envvalues =
+						std::make_shared<std::deque<std::vector<const char*>>>();
+				}
+				frame.envcopies->emplace_back(value);
+				std::string &copy = frame.envcopies->back();
+				char *end = tokenize(&copy[0], &copy[0] + copy.size());
+				//a remainder flag keeps the ArgIter, so the array outlives it
+				frame.envvalues->emplace_back();
+				std::vector<const char*> &values = frame.envvalues->back();
+				for (
+					char *token = &copy[0]; end && token < end;
+					token += std::strlen(token) + 1)
+				{ values.push_back(token); }
+				ArgIter it(static_cast<int>(values.size()), values.data(), "");
+				ok = end && parsearg(flag, it, frame) && !it;
+			}
+			if (!ok)
+			{
+				return fail(
+					frame, result.error, ParseResult::Error::bad_environment,
+					-1, name, value - 1 - name, 0, flag);
+			}
+			result.args.set(flag->id);
+			result.envargs.set(flag->id);
 		}
-		result.args.insert(*posit);
-		++posit;
 		return 0;
 	}
 
-	void Parser::check_required(
-		ParseResult &result,
-		decltype(pos)::const_iterator &posit) const
+	void Parser::check_required(Frame &frame) const
 	{
-		for (; posit != pos.end(); ++posit)
+		ParseResult &result = frame.result;
+		for (; frame.posit != pos.end(); ++frame.posit)
 		{
-			if ((*posit)->required)
+			if ((*frame.posit)->required)
 			{
-				out << "Missing required positional argument \""
-					<< (*posit)->names[0] << '"' << std::endl;
-				result.code = result.missing;
+				const char *name = (*frame.posit)->names[0];
+				fail(
+					frame, result.missing, ParseResult::Error::missing_positional,
+					-1, name, std::strlen(name), 0, *frame.posit);
 				return;
 			}
 		}
+		if (result.args.contains(requiredflags)) { return; }
 		for (auto flagpair : flags)
 		{
 			if (
 				flagpair.second->required
-				&& result.args.find(flagpair.second) == result.args.end())
+				&& !result.args.test(flagpair.second->id))
 			{
-				out << "Missing required flag \""
-					<< Flagname{prefix, most<gt>(flagpair.second->names)}
-					<< '"' << std::endl;
-				result.code = result.missing;
+				const char *name = most<gt>(flagpair.second->names);
+				std::size_t size = std::strlen(name);
+				fail(
+					frame, result.missing, ParseResult::Error::missing_flag,
+					-1, name, size, size > 1 ? 2 : 1, flagpair.second);
 				return;
 			}
 		}
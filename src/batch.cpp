@@ -0,0 +1,199 @@
+#include "argparse/argparse.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace argparse
+{
+	namespace
+	{
+		//Rows claimed at a time.
+		const std::size_t chunk = 16;
+
+		struct Range
+		{
+			std::atomic<std::size_t> next;
+			std::size_t end;
+		};
+
+		//Joins the started threads, also when starting another throws.
+		struct Pool
+		{
+			std::vector<std::thread> threads;
+			~Pool()
+			{
+				for (auto &thread : threads)
+				{ if (thread.joinable()) { thread.join(); } }
+			}
+		};
+	}
+
+	Batch::Batch(const Parser &parser, std::size_t rows):
+		parser(parser),
+		codes(rows, ParseResult::success),
+		args(rows),
+		failures(rows, ParseResult::Error{}),
+		subcommands(rows),
+		envargs(rows),
+		configargs(rows),
+		storage(rows),
+		columns{},
+		strides{},
+		arenas{},
+		live(rows, 0)
+	{
+		if (!parser.frozen) { parser.freeze(); }
+		for (std::size_t idx=0; idx<parser.args.size(); ++idx)
+		{
+			if (parser.slotoffsets[idx] == static_cast<std::size_t>(-1))
+			{
+				throw std::logic_error(
+					"Arg does not support Values: "
+					+ std::string(parser.args[idx]->names[0]));
+			}
+			std::size_t align = parser.args[idx]->slot_align();
+			std::size_t stride = (parser.args[idx]->slot_size() + align - 1)
+				/ align * align;
+			strides.push_back(stride);
+			columns.emplace_back(new char[stride * rows]);
+		}
+	}
+
+	Batch::~Batch()
+	{
+		for (std::size_t row=0; row<live.size(); ++row)
+		{
+			if (!live[row]) { continue; }
+			for (std::size_t idx=0; idx<columns.size(); ++idx)
+			{
+				parser.args[idx]->slot_free(
+					columns[idx].get() + row * strides[idx]);
+			}
+		}
+	}
+
+	void Batch::check(const ArgCommon &arg) const
+	{
+		if (arg.id >= columns.size() || parser.args[arg.id] != &arg)
+		{ throw std::logic_error("Arg does not belong to the parser."); }
+	}
+
+	void* Batch::slot(const ArgCommon &arg, std::size_t row)
+	{
+		check(arg);
+		if (row >= size()) { throw std::out_of_range("Batch row out of range."); }
+		return columns[arg.id].get() + row * strides[arg.id];
+	}
+
+	void Batch::init(
+		std::size_t row, void **slots, std::pmr::memory_resource *resource)
+	{
+		std::size_t idx = 0;
+		try
+		{
+			for (; idx<columns.size(); ++idx)
+			{
+				slots[idx] = columns[idx].get() + row * strides[idx];
+				parser.args[idx]->slot_init(slots[idx], resource);
+			}
+		}
+		catch (...)
+		{
+			while (idx) { --idx; parser.args[idx]->slot_free(slots[idx]); }
+			throw;
+		}
+		live[row] = 1;
+	}
+
+	Batch Parser::parse_batch(
+		const std::vector<std::vector<const char*>> &rows,
+		unsigned threads) const
+	{ return parse_batch(rows.data(), rows.size(), threads); }
+
+	Batch Parser::parse_batch(
+		const std::vector<const char*> *rows, std::size_t count,
+		unsigned threads) const
+	{
+		if (!frozen) { freeze(); }
+		Batch batch(*this, count);
+		if (!threads) { threads = std::thread::hardware_concurrency(); }
+		std::size_t chunks = (count + chunk - 1) / chunk;
+		threads = static_cast<unsigned>(
+			std::max<std::size_t>(1, std::min<std::size_t>(threads, chunks)));
+
+		//Each worker starts on its own range of rows and then steals
+		//chunks from the other ranges.
+		std::unique_ptr<Range[]> ranges(new Range[threads]);
+		for (unsigned idx=0; idx<threads; ++idx)
+		{
+			ranges[idx].next = count * idx / threads;
+			ranges[idx].end = count * (idx + 1) / threads;
+			batch.arenas.emplace_back(new std::pmr::monotonic_buffer_resource());
+		}
+		std::atomic<bool> failed(false);
+		std::exception_ptr error;
+		std::mutex lock;
+		auto work = [&](unsigned self)
+		{
+			try
+			{
+				std::vector<void*> slots(args.size());
+				std::pmr::memory_resource *arena = batch.arenas[self].get();
+				for (unsigned k=0; k<threads && !failed; ++k)
+				{
+					Range &range = ranges[(self + k) % threads];
+					for (
+						std::size_t start = range.next.fetch_add(chunk);
+						start < range.end && !failed;
+						start = range.next.fetch_add(chunk))
+					{
+						std::size_t stop = std::min(start + chunk, range.end);
+						for (std::size_t row=start; row<stop; ++row)
+						{
+							batch.init(row, slots.data(), arena);
+							ArgIter it(
+								static_cast<int>(rows[row].size()),
+								rows[row].data(), prefix, filemark());
+							ParseResult result = run(it, slots.data(), nullptr, true, true, out);
+							batch.codes[row] = result.code;
+							batch.args[row] = std::move(result.args);
+							batch.failures[row] = result.failure;
+							batch.subcommands[row] = std::move(result.subcommand);
+							batch.envargs[row] = std::move(result.envargs);
+							batch.configargs[row] = std::move(result.configargs);
+							batch.storage[row] = std::move(result.storage);
+						}
+					}
+				}
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				if (!error) { error = std::current_exception(); }
+				failed = true;
+			}
+		};
+		{
+			Pool pool;
+			try
+			{
+				for (unsigned idx=1; idx<threads; ++idx)
+				{ pool.threads.emplace_back(work, idx); }
+			}
+			catch (...)
+			{
+				failed = true;
+				throw;
+			}
+			work(0);
+		}
+		if (error) { std::rethrow_exception(error); }
+		return batch;
+	}
+}
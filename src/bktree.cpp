@@ -0,0 +1,184 @@
+#include "argparse/bktree.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace argparse
+{
+	namespace
+	{
+		struct Found
+		{
+			std::size_t dist;
+			const char *name;
+			std::size_t id;
+		};
+
+		inline bool closer(const Found &a, const Found &b)
+		{
+			return a.dist < b.dist
+				|| (a.dist == b.dist && std::strcmp(a.name, b.name) < 0);
+		}
+
+		//Insert f into found[0, size), sorted by closer() with at most
+		//one entry per id and at most count entries.
+		void insert(Found *found, std::size_t &size, std::size_t count, const Found &f)
+		{
+			std::size_t i = 0;
+			while (i < size && found[i].id != f.id) { ++i; }
+			if (i < size)
+			{
+				if (!closer(f, found[i])) { return; }
+				std::move(found + i + 1, found + size, found + i);
+				--size;
+			}
+			std::size_t pos = std::upper_bound(found, found + size, f, closer) - found;
+			if (pos >= count) { return; }
+			std::size_t end = size < count ? size + 1 : count;
+			std::move_backward(found + pos, found + end - 1, found + end);
+			found[pos] = f;
+			size = end;
+		}
+	}
+
+	void BKTree::clear()
+	{
+		nodes.clear();
+		pending = 0;
+	}
+
+	void BKTree::build(
+		const std::vector<const char*> &names,
+		const std::vector<std::size_t> &ids)
+	{
+		clear();
+		nodes.reserve(names.size());
+		for (std::size_t i=0; i<names.size(); ++i)
+		{
+			const char *name = names[i];
+			Node node{
+				name, std::strlen(name), ids.empty() ? i : ids[i], 0, none, none};
+			if (nodes.empty())
+			{
+				nodes.push_back(node);
+				continue;
+			}
+			std::uint32_t cur = 0;
+			while (true)
+			{
+				std::size_t d = distance(
+					nodes[cur].name, nodes[cur].size, node.name, node.size);
+				std::uint32_t child = nodes[cur].child;
+				while (child != none && nodes[child].dist != d)
+				{ child = nodes[child].sibling; }
+				if (child != none)
+				{
+					cur = child;
+					continue;
+				}
+				node.dist = d;
+				node.sibling = nodes[cur].child;
+				nodes[cur].child = static_cast<std::uint32_t>(nodes.size());
+				nodes.push_back(node);
+				break;
+			}
+		}
+		//A search pushes a subset of the children a full walk pushes, in
+		//the same order, so it never needs a deeper stack.
+		std::vector<std::uint32_t> stack;
+		if (nodes.size()) { stack.push_back(0); }
+		while (stack.size())
+		{
+			std::uint32_t cur = stack.back();
+			stack.pop_back();
+			for (std::uint32_t child = nodes[cur].child; child != none;)
+			{
+				stack.push_back(child);
+				child = nodes[child].sibling;
+			}
+			pending = std::max(pending, stack.size());
+		}
+	}
+
+	std::size_t BKTree::nearest(
+		const char *name, std::size_t maxdist,
+		const char **out, std::size_t count) const
+	{
+		if (nodes.empty() || !count) { return 0; }
+		std::size_t size = std::strlen(name);
+		Found localfound[maxlocal];
+		std::vector<Found> heapfound;
+		Found *found = localfound;
+		if (count > maxlocal)
+		{
+			heapfound.resize(count);
+			found = heapfound.data();
+		}
+		std::size_t nfound = 0;
+		std::uint32_t localpending[localstack];
+		std::vector<std::uint32_t> heappending;
+		std::uint32_t *stack = localpending;
+		if (pending > localstack)
+		{
+			heappending.resize(pending);
+			stack = heappending.data();
+		}
+		std::size_t top = 0;
+		stack[top++] = 0;
+		std::size_t bound = maxdist;
+		while (top)
+		{
+			const Node &node = nodes[stack[--top]];
+			std::size_t d = distance(node.name, node.size, name, size);
+			if (d <= bound)
+			{
+				insert(found, nfound, count, Found{d, node.name, node.id});
+				if (nfound == count) { bound = found[nfound-1].dist; }
+			}
+			for (std::uint32_t child = node.child; child != none;)
+			{
+				const Node &c = nodes[child];
+				if (c.dist + bound >= d && c.dist <= d + bound)
+				{ stack[top++] = child; }
+				child = c.sibling;
+			}
+		}
+		for (std::size_t i=0; i<nfound; ++i) { out[i] = found[i].name; }
+		return nfound;
+	}
+
+	std::size_t BKTree::distance(
+		const char *a, std::size_t asize, const char *b, std::size_t bsize)
+	{
+		if (asize < bsize)
+		{
+			std::swap(a, b);
+			std::swap(asize, bsize);
+		}
+		//Two rows over the shorter string.
+		std::size_t local[2][64];
+		std::vector<std::size_t> heap;
+		std::size_t *prev = local[0];
+		std::size_t *cur = local[1];
+		if (bsize >= 64)
+		{
+			heap.resize(2 * (bsize + 1));
+			prev = &heap[0];
+			cur = &heap[bsize + 1];
+		}
+		for (std::size_t j=0; j<=bsize; ++j) { prev[j] = j; }
+		for (std::size_t i=1; i<=asize; ++i)
+		{
+			cur[0] = i;
+			for (std::size_t j=1; j<=bsize; ++j)
+			{
+				cur[j] = std::min({
+					prev[j] + 1,
+					cur[j-1] + 1,
+					prev[j-1] + (a[i-1] != b[j-1])});
+			}
+			std::swap(prev, cur);
+		}
+		return prev[bsize];
+	}
+}
@@ -0,0 +1,214 @@
+#include "argparse/argparse.hpp"
+#include "argparse/mapped.hpp"
+#include "argparse/tokenize.hpp"
+
+//Only these spell out nanosecond stat times, elsewhere the file is
+//read on every parse.
+#if defined(__linux__) || defined(__APPLE__)
+#define ARGPARSE_CONFIG_STAMP
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace argparse
+{
+	namespace
+	{
+		inline bool isblank(char c)
+		{ return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+		inline char* lstrip(char *begin, char *end)
+		{
+			while (begin < end && isblank(*begin)) { ++begin; }
+			return begin;
+		}
+
+		inline char* rstrip(char *begin, char *end)
+		{
+			while (end > begin && isblank(end[-1])) { --end; }
+			return end;
+		}
+
+		//What identifies a file's contents without reading them.
+		//Same-second edits change the nanoseconds, a rename-replace
+		//changes the inode and ctime.
+		struct Stamp
+		{
+#ifdef ARGPARSE_CONFIG_STAMP
+			ino_t ino;
+			long long size;
+			timespec mtime;
+			timespec ctime;
+#endif
+			bool operator==(const Stamp &other) const
+			{
+#ifdef ARGPARSE_CONFIG_STAMP
+				return ino == other.ino && size == other.size
+					&& mtime.tv_sec == other.mtime.tv_sec
+					&& mtime.tv_nsec == other.mtime.tv_nsec
+					&& ctime.tv_sec == other.ctime.tv_sec
+					&& ctime.tv_nsec == other.ctime.tv_nsec;
+#else
+				return false;
+#endif
+			}
+		};
+
+		//False if the file cannot be stat'ed or the times are too coarse
+		//to trust.
+		bool stamp(const char *path, Stamp &out)
+		{
+#ifdef ARGPARSE_CONFIG_STAMP
+			struct stat info;
+			if (::stat(path, &info)) { return false; }
+			out.ino = info.st_ino;
+			out.size = info.st_size;
+#ifdef __APPLE__
+			out.mtime = info.st_mtimespec;
+			out.ctime = info.st_ctimespec;
+#else
+			out.mtime = info.st_mtim;
+			out.ctime = info.st_ctim;
+#endif
+			return true;
+#else
+			return false;
+#endif
+		}
+	}
+
+	//A config file split into entries, shared by the parses using it.
+	//Values are split in place once, parses only convert them.
+	struct ConfigFile
+	{
+		struct Entry
+		{
+			//nullptr for an unknown name or a line without '='
+			FlagCommon *flag;
+			int line;
+			//false if the value has an unclosed quote
+			bool ok;
+			std::vector<const char*> values;
+		};
+
+		std::string path;
+		//the file when it was read, only cached if it was stamped
+		Stamp stamp;
+		MappedFile map;
+		std::vector<Entry> entries;
+
+		ConfigFile(const char *path, const Stamp &stamp):
+			path(path),
+			stamp(stamp),
+			map(path),
+			entries{}
+		{}
+	};
+
+	std::shared_ptr<const ConfigFile> Parser::load_config() const
+	{
+		Stamp current{};
+		bool known = stamp(config, current);
+		std::lock_guard<std::mutex> guard(configlock);
+		if (
+			known && configcache && configcache->path == config
+			&& configcache->stamp == current)
+		{ return configcache; }
+		auto file = std::make_shared<ConfigFile>(config, current);
+		char *data = file->map.data();
+		char *stop = data + file->map.size();
+		int line = 0;
+		for (char *begin = data; file->map && begin < stop;)
+		{
+			++line;
+			char *end = static_cast<char*>(std::memchr(begin, '\n', stop - begin));
+			if (!end) { end = stop; }
+			char *key = lstrip(begin, end);
+			begin = end + 1;
+			if (key == end || *key == '#') { continue; }
+			char *eq = static_cast<char*>(std::memchr(key, '=', end - key));
+			ConfigFile::Entry entry{nullptr, line, true, {}};
+			if (eq)
+			{
+				std::size_t idx = table.find(key, rstrip(key, eq) - key);
+				if (idx != table.npos) { entry.flag = tableflags[idx]; }
+			}
+			if (!entry.flag)
+			{
+				//nothing after an unknown name is used
+				file->entries.push_back(std::move(entry));
+				break;
+			}
+			char *value = lstrip(eq + 1, end);
+			char *valueend = rstrip(value, end);
+			int nargs = entry.flag->nargs();
+			if (!nargs)
+			{
+				*valueend = '\0';
+				if (!given(value)) { continue; }
+			}
+			else if (nargs == 1 && *value != '\'' && *value != '"')
+			{
+				//the rest of the line is the value
+				*valueend = '\0';
+				entry.values.push_back(value);
+			}
+			else
+			{
+				char *packed = tokenize(value, valueend);
+				entry.ok = packed;
+				for (
+					char *token = value; packed && token < packed;
+					token += std::strlen(token) + 1)
+				{ entry.values.push_back(token); }
+			}
+			file->entries.push_back(std::move(entry));
+		}
+		if (known) { configcache = file; }
+		return file;
+	}
+
+	int Parser::read_config(Frame &frame) const
+	{
+		ParseResult &result = frame.result;
+		std::size_t pathsize = std::strlen(config);
+		auto file = load_config();
+		if (!file->map)
+		{
+			return fail(
+				frame, result.error, ParseResult::Error::bad_config,
+				0, config, pathsize, 0, nullptr);
+		}
+		frame.configfile = file;
+		result.configargs.resize(args.size());
+		for (const ConfigFile::Entry &entry : file->entries)
+		{
+			FlagCommon *flag = entry.flag;
+			if (!flag)
+			{
+				return fail(
+					frame, result.error, ParseResult::Error::bad_config,
+					entry.line, config, pathsize, 0, nullptr);
+			}
+			//args and environment take priority, the first line is used
+			if (result.args.test(flag->id)) { continue; }
+			ArgIter it(
+				static_cast<int>(entry.values.size()), entry.values.data(), "");
+			if (!(entry.ok && parsearg(flag, it, frame) && !it))
+			{
+				return fail(
+					frame, result.error, ParseResult::Error::bad_config,
+					entry.line, config, pathsize, 0, flag);
+			}
+			result.args.set(flag->id);
+			result.configargs.set(flag->id);
+		}
+		return 0;
+	}
+}
@@ -0,0 +1,94 @@
+// Character classes and the decimal digit kernel shared by the number
+// parsers in src/.  Not installed.
+#ifndef ARGPARSE_LEX_HPP
+#define ARGPARSE_LEX_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define ARGPARSE_NO_SWAR
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer)
+#define ARGPARSE_NO_SWAR
+#endif
+#endif
+
+#if !defined(ARGPARSE_NO_SWAR) && ( \
+	(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) \
+	|| defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64))
+#define ARGPARSE_SWAR
+#endif
+
+namespace argparse { namespace lex
+{
+	//std::isspace in the C locale.
+	inline bool isspace(char c)
+	{ return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+#ifdef ARGPARSE_SWAR
+	//Load 8 bytes at p if they are in the same page.  The bytes after
+	//the terminating NUL are read but never used.
+	inline bool load8(const char *p, std::uint64_t &word)
+	{
+		if ((reinterpret_cast<std::uintptr_t>(p) & 4095) > 4096 - 8)
+		{ return false; }
+		std::memcpy(&word, p, 8);
+		return true;
+	}
+
+	inline bool eightdigits(std::uint64_t word)
+	{
+		return (
+			(word & 0xF0F0F0F0F0F0F0F0ull)
+			| (((word + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)
+		) == 0x3333333333333333ull;
+	}
+
+	//Value of 8 ascii digits, first digit in the lowest byte.
+	inline std::uint64_t eightvalue(std::uint64_t word)
+	{
+		const std::uint64_t mask = 0x000000FF000000FFull;
+		const std::uint64_t mul1 = 100 + (1000000ull << 32);
+		const std::uint64_t mul2 = 1 + (10000ull << 32);
+		word -= 0x3030303030303030ull;
+		word = word * 10 + (word >> 8);
+		return (
+			((word & mask) * mul1) + (((word >> 16) & mask) * mul2)) >> 32;
+	}
+#endif
+
+	//Accumulate the decimal digits at p into out, 8 at a time where
+	//possible.  Return the end of the digits (p if there are none) or
+	//nullptr if the value is larger than limit.
+	template<unsigned long long limit>
+	const char* decimal(const char *p, unsigned long long &out)
+	{
+		typedef unsigned long long ull;
+		ull acc = 0;
+#ifdef ARGPARSE_SWAR
+		const ull cutoff8 = limit / 100000000ull;
+		const ull cutlim8 = limit % 100000000ull;
+		std::uint64_t word;
+		while (load8(p, word) && eightdigits(word))
+		{
+			ull v = eightvalue(word);
+			if (acc > cutoff8 || (acc == cutoff8 && v > cutlim8))
+			{ return nullptr; }
+			acc = acc * 100000000ull + v;
+			p += 8;
+		}
+#endif
+		const ull cutoff = limit / 10;
+		const unsigned cutlim = limit % 10;
+		for (unsigned d; (d = static_cast<unsigned char>(*p) - '0') < 10; ++p)
+		{
+			if (acc > cutoff || (acc == cutoff && d > cutlim))
+			{ return nullptr; }
+			acc = acc * 10 + d;
+		}
+		out = acc;
+		return p;
+	}
+}}
+#endif //ARGPARSE_LEX_HPP
@@ -0,0 +1,89 @@
+#include "argparse/mapped.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace argparse
+{
+	MappedFile::MappedFile(const char *path):
+		base(nullptr),
+		count(0),
+		mapped(0),
+		buffer{},
+		ok(false)
+	{
+#ifndef _WIN32
+		int fd = ::open(path, O_RDONLY);
+		if (fd < 0) { return; }
+		struct stat info;
+		if (::fstat(fd, &info))
+		{
+			::close(fd);
+			return;
+		}
+		if (S_ISREG(info.st_mode))
+		{
+			count = static_cast<std::size_t>(info.st_size);
+			std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+			//The rest of the last page is zero-filled and writable.
+			if (count % page)
+			{
+				void *p = ::mmap(
+					nullptr, count, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+				if (p != MAP_FAILED)
+				{
+					base = static_cast<char*>(p);
+					mapped = count;
+					ok = true;
+					::close(fd);
+					return;
+				}
+			}
+		}
+		//Pipes, /dev/stdin, etc are read until EOF.
+		std::FILE *f = ::fdopen(fd, "rb");
+		if (!f)
+		{
+			::close(fd);
+			return;
+		}
+#else
+		std::FILE *f = std::fopen(path, "rb");
+		if (!f) { return; }
+#endif
+		//The size is only a hint, read until EOF.
+		std::size_t capacity = std::max<std::size_t>(count + 1, 4096);
+		buffer.reset(new char[capacity]);
+		count = 0;
+		while (std::size_t n = std::fread(
+			buffer.get() + count, 1, capacity - 1 - count, f))
+		{
+			count += n;
+			if (count + 1 == capacity)
+			{
+				std::unique_ptr<char[]> grow(new char[capacity * 2]);
+				std::copy(buffer.get(), buffer.get() + count, grow.get());
+				buffer.swap(grow);
+				capacity *= 2;
+			}
+		}
+		ok = !std::ferror(f);
+		std::fclose(f);
+		base = buffer.get();
+		base[count] = '\0';
+	}
+
+	MappedFile::~MappedFile()
+	{
+#ifndef _WIN32
+		if (mapped) { ::munmap(base, mapped); }
+#endif
+	}
+}
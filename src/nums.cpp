@@ -1,23 +1,242 @@
 #include "argparse/nums.hpp"
+#include "lex.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 namespace argparse
 {
-#define SPECIALIZE(T, valcheck, prefix) \
+	namespace
+	{
+		typedef unsigned long long ull;
+
+		using lex::isspace;
+
+		struct DigitTable
+		{ unsigned char value[256]; };
+
+		constexpr DigitTable makedigits()
+		{
+			DigitTable table{};
+			for (unsigned c=0; c<256; ++c)
+			{
+				unsigned d = c - '0';
+				unsigned letter = (c | 0x20) - 'a';
+				table.value[c] = static_cast<unsigned char>(
+					d < 10 ? d : letter < 26 ? letter + 10 : 36);
+			}
+			return table;
+		}
+
+		constexpr DigitTable digittable = makedigits();
+
+		//Value of c as a digit, >= 36 if not a digit in any base.
+		inline unsigned digit(char c)
+		{ return digittable.value[static_cast<unsigned char>(c)]; }
+
+		//log2(base) for power of 2 bases, 0 otherwise.
+		constexpr unsigned radixshift(unsigned base)
+		{
+			return base < 2 || (base & (base-1))
+				? 0 : base == 2 ? 1 : 1 + radixshift(base >> 1);
+		}
+
+		template<ull limit>
+		const char* digits(const char *p, unsigned base, ull &out)
+		{
+			if (base == 10) { return lex::decimal<limit>(p, out); }
+			ull acc = 0;
+			const ull cutoff = limit / base;
+			const unsigned cutlim = static_cast<unsigned>(limit % base);
+			for (unsigned d; (d = digit(*p)) < base; ++p)
+			{
+				if (acc > cutoff || (acc == cutoff && d > cutlim))
+				{ return nullptr; }
+				acc = acc * base + d;
+			}
+			out = acc;
+			return p;
+		}
+
+		//digits() for a base known at compile time.
+		template<unsigned base, ull limit>
+		const char* radixdigits(const char *p, ull &out)
+		{
+			if (base == 10) { return lex::decimal<limit>(p, out); }
+			const unsigned shift = radixshift(base);
+			const ull cutoff = limit / base;
+			const unsigned cutlim = static_cast<unsigned>(limit % base);
+			ull acc = 0;
+			for (unsigned d; (d = digit(*p)) < base; ++p)
+			{
+				if (acc > cutoff || (acc == cutoff && d > cutlim))
+				{ return nullptr; }
+				acc = shift ? (acc << shift) | d : acc * base + d;
+			}
+			out = acc;
+			return p;
+		}
+
+		template<class W>
+		struct Limits
+		{
+			static const ull pos = std::numeric_limits<W>::max();
+			static const ull neg = std::is_signed<W>::value ? pos + 1 : pos;
+		};
+
+		template<unsigned base, class W>
+		const char* radixmagnitude(const char *p, bool negative, ull &out)
+		{
+			return negative
+				? radixdigits<base, Limits<W>::neg>(p, out)
+				: radixdigits<base, Limits<W>::pos>(p, out);
+		}
+
+		//Skip whitespace and the sign.
+		inline const char* sign(const char *p, bool &negative)
+		{
+			while (isspace(*p)) { ++p; }
+			negative = *p == '-';
+			if (*p == '-' || *p == '+') { ++p; }
+			return p;
+		}
+
+		//Check the digits from begin to end (nullptr if they overflowed)
+		//and trailing whitespace, then apply the sign and check the
+		//range of T.
+		template<class T, class W>
+		bool finishint(
+			T &dst, const char *begin, const char *end, bool negative,
+			ull magnitude)
+		{
+			if (!end || end == begin) { return false; }
+			while (isspace(*end)) { ++end; }
+			if (*end) { return false; }
+			W value = static_cast<W>(negative ? 0 - magnitude : magnitude);
+			if (
+				value < std::numeric_limits<T>::min()
+				|| value > std::numeric_limits<T>::max())
+			{ return false; }
+			dst = static_cast<T>(value);
+			return true;
+		}
+
+		//Parse as strtol (W signed) or strtoul (W unsigned) would into a
+		//W, then check the range of T.
+		template<class T, class W>
+		bool storeint(T &dst, const char *arg, int base)
+		{
+			if (base && (base < 2 || base > 36)) { return false; }
+			bool negative;
+			const char *p = sign(arg, negative);
+			//0x is only a prefix if a hex digit follows.
+			bool hex = p[0] == '0' && (p[1] | 0x20) == 'x' && digit(p[2]) < 16;
+			if (!base) { base = hex ? 16 : p[0] == '0' ? 8 : 10; }
+			if (base == 16 && hex) { p += 2; }
+			ull magnitude = 0;
+			const char *end = negative
+				? digits<Limits<W>::neg>(p, static_cast<unsigned>(base), magnitude)
+				: digits<Limits<W>::pos>(p, static_cast<unsigned>(base), magnitude);
+			return finishint<T, W>(dst, p, end, negative, magnitude);
+		}
+
+		//Base of a 0x, 0o or 0b prefix at p (if a digit follows), else 8
+		//for another leading 0 as strtol base 0, else 10.
+		inline unsigned prefixbase(const char *&p)
+		{
+			if (p[0] != '0') { return 10; }
+			unsigned base;
+			switch (p[1] | 0x20)
+			{
+				case 'x': base = 16; break;
+				case 'o': base = 8; break;
+				case 'b': base = 2; break;
+				default: return 8;
+			}
+			if (digit(p[2]) >= base) { return 8; }
+			p += 2;
+			return base;
+		}
+
+		//storeint() with the base fixed at compile time.  Base 0 reads
+		//the prefix and the digits in the same pass.
+		template<unsigned base, class T, class W>
+		bool storefixed(T &dst, const char *arg)
+		{
+			bool negative;
+			const char *p = sign(arg, negative);
+			ull magnitude = 0;
+			const char *end;
+			if (base)
+			{
+				if (
+					base == 16 && p[0] == '0' && (p[1] | 0x20) == 'x'
+					&& digit(p[2]) < 16)
+				{ p += 2; }
+				end = radixmagnitude<base ? base : 10, W>(p, negative, magnitude);
+			}
+			else
+			{
+				switch (prefixbase(p))
+				{
+					case 16: end = radixmagnitude<16, W>(p, negative, magnitude); break;
+					case 8: end = radixmagnitude<8, W>(p, negative, magnitude); break;
+					case 2: end = radixmagnitude<2, W>(p, negative, magnitude); break;
+					default: end = radixmagnitude<10, W>(p, negative, magnitude); break;
+				}
+			}
+			return finishint<T, W>(dst, p, end, negative, magnitude);
+		}
+
+		//The type strtol/strtoul would parse T as.
+		template<class T>
+		struct Wide
+		{
+			typedef typename std::conditional<
+				std::is_same<T, long>::value || std::is_same<T, unsigned long>::value,
+				T,
+				typename std::conditional<
+					std::is_signed<T>::value, long long, unsigned long long
+				>::type
+			>::type type;
+		};
+	}
+
+	template<int base, class T>
+	bool storeradix(T &dst, const char *arg)
+	{ return storefixed<base, T, typename Wide<T>::type>(dst, arg); }
+
+#define SPECIALIZE(T, W, prefix) \
 	template<> \
 	bool store<prefix T>(prefix T &dst, const char *arg, int base) \
-	{ \
-		prefix long long v; \
-		if (store(v, arg, base) && valcheck) \
-		{ \
-			dst = static_cast<prefix T>(v); \
-			return true; \
-		} \
-		return false; \
-	}
-	SPECIALIZE(int, INT_MIN <= v && v <= INT_MAX, )
-	SPECIALIZE(short, SHRT_MIN <= v && v <= SHRT_MAX, )
-	SPECIALIZE(short, v <= USHRT_MAX, unsigned)
-	SPECIALIZE(int, v <= UINT_MAX, unsigned)
+	{ return storeint<prefix T, W>(dst, arg, base); }
+	SPECIALIZE(short, long long, )
+	SPECIALIZE(int, long long, )
+	SPECIALIZE(long, long, )
+	SPECIALIZE(long long, long long, )
+	SPECIALIZE(short, unsigned long long, unsigned)
+	SPECIALIZE(int, unsigned long long, unsigned)
+	SPECIALIZE(long, unsigned long, unsigned)
+	SPECIALIZE(long long, unsigned long long, unsigned)
 #undef SPECIALIZE
 
+#define INSTANTIATE(T) \
+	template bool storeradix<0, T>(T &dst, const char *arg); \
+	template bool storeradix<2, T>(T &dst, const char *arg); \
+	template bool storeradix<4, T>(T &dst, const char *arg); \
+	template bool storeradix<8, T>(T &dst, const char *arg); \
+	template bool storeradix<16, T>(T &dst, const char *arg); \
+	template bool storeradix<32, T>(T &dst, const char *arg);
+	INSTANTIATE(short)
+	INSTANTIATE(int)
+	INSTANTIATE(long)
+	INSTANTIATE(long long)
+	INSTANTIATE(unsigned short)
+	INSTANTIATE(unsigned int)
+	INSTANTIATE(unsigned long)
+	INSTANTIATE(unsigned long long)
+#undef INSTANTIATE
+
 }
@@ -0,0 +1,252 @@
+#include "argparse/rangelist.hpp"
+#include "lex.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+namespace argparse
+{
+	namespace
+	{
+		typedef RangeList::value_type value_type;
+		typedef RangeList::Range Range;
+
+		constexpr value_type maxvalue = std::numeric_limits<value_type>::max();
+		//Most values listed where two ranges interleave.
+		constexpr value_type maxlisted = 1 << 16;
+
+		using lex::isspace;
+
+		//Read the digits at p.  Return their end or nullptr if there are
+		//none or they overflow.
+		const char* number(const char *p, value_type &out)
+		{
+			const char *end = lex::decimal<maxvalue>(p, out);
+			return end != p ? end : nullptr;
+		}
+
+		inline bool ongrid(const Range &r, value_type value)
+		{ return (value - r.first) % r.step == 0; }
+
+		//First value of r after value, r.first <= value < r.last.
+		inline value_type after(const Range &r, value_type value)
+		{ return r.first + ((value - r.first) / r.step + 1) * r.step; }
+
+		//Last value of r before value, r.first < value.
+		inline value_type before(const Range &r, value_type value)
+		{ return r.first + ((value - 1 - r.first) / r.step) * r.step; }
+
+		inline void settle(Range &r)
+		{ if (r.first == r.last) { r.step = 1; } }
+
+		//Push the values of r from first (on r) up to stop one by one.
+		template<class Queue>
+		void listvalues(
+			Queue &pending, const Range &r, value_type first, value_type stop)
+		{
+			for (value_type v = first; ; v += r.step)
+			{
+				pending.push(Range{v, v, 1});
+				if (stop - v < r.step) { break; }
+			}
+		}
+
+		//Split arg into ranges.  False if it is not a range list.
+		bool split(const char *arg, std::vector<Range> &ranges)
+		{
+			const char *p = arg;
+			while (isspace(*p)) { ++p; }
+			while (true)
+			{
+				Range r{0, 0, 1};
+				if (!(p = number(p, r.first))) { return false; }
+				r.last = r.first;
+				if (*p == '-')
+				{
+					if (!(p = number(p+1, r.last))) { return false; }
+					if (*p == ':' && !(p = number(p+1, r.step))) { return false; }
+				}
+				ranges.push_back(r);
+				if (*p != ',') { break; }
+				++p;
+			}
+			while (isspace(*p)) { ++p; }
+			return !*p;
+		}
+
+		//Heap order: by first, containing ranges (smaller steps, then
+		//larger lasts) before the ranges they contain.
+		struct Later
+		{
+			bool operator()(const Range &a, const Range &b) const
+			{
+				if (a.first != b.first) { return a.first > b.first; }
+				if (a.step != b.step) { return a.step > b.step; }
+				return a.last < b.last;
+			}
+		};
+	}
+
+	RangeList::RangeList(const char *spec)
+	{
+		std::vector<Range> input;
+		if (!split(spec, input))
+		{ throw std::logic_error("Bad range list: " + std::string(spec)); }
+		if (!assign(std::move(input)))
+		{
+			throw std::logic_error(
+				"Range list overlaps too much to merge: " + std::string(spec));
+		}
+	}
+
+	RangeList::value_type RangeList::count() const
+	{
+		value_type total = 0;
+		for (const Range &r : ranges)
+		{
+			value_type n = (r.last - r.first) / r.step;
+			if (n >= maxvalue - total) { return maxvalue; }
+			total += n + 1;
+		}
+		return total;
+	}
+
+	bool RangeList::contains(value_type value) const
+	{
+		auto it = std::upper_bound(
+			ranges.begin(), ranges.end(), value,
+			[](value_type v, const Range &r) { return v < r.first; });
+		if (it == ranges.begin()) { return false; }
+		--it;
+		return value <= it->last && ongrid(*it, value);
+	}
+
+	bool RangeList::bitmask(BitSet &bits, std::size_t limit) const
+	{
+		if (!ranges.empty() && ranges.back().last >= limit) { return false; }
+		bits.resize(ranges.empty() ? 0 : ranges.back().last + 1);
+		for (value_type value : *this) { bits.set(value); }
+		return true;
+	}
+
+	bool RangeList::assign(std::vector<Range> input)
+	{
+		for (Range &r : input)
+		{
+			if (!r.step || r.first > r.last) { return false; }
+			r.last = r.first + (r.last - r.first) / r.step * r.step;
+			settle(r);
+		}
+		std::priority_queue<Range, std::vector<Range>, Later> pending(
+			Later{}, std::move(input));
+		std::vector<Range> merged;
+		while (!pending.empty())
+		{
+			Range r = pending.top();
+			pending.pop();
+			if (merged.empty())
+			{
+				merged.push_back(r);
+				continue;
+			}
+			Range &cur = merged.back();
+			if (r.first > cur.last)
+			{
+				if (
+					r.step == cur.step && cur.last <= maxvalue - cur.step
+					&& r.first == cur.last + cur.step)
+				{ cur.last = r.last; }
+				else
+				{ merged.push_back(r); }
+			}
+			else if (
+				ongrid(cur, r.first) && r.last <= cur.last
+				&& (r.first == r.last || r.step % cur.step == 0))
+			{}
+			else if (r.step == cur.step && ongrid(cur, r.first))
+			{ cur.last = std::max(cur.last, r.last); }
+			else if (ongrid(cur, r.first) && r.step % cur.step == 0)
+			{
+				//r continues past cur, keep the rest of it.
+				r.first = after(r, cur.last);
+				settle(r);
+				pending.push(r);
+			}
+			else if (
+				cur.step % r.step == 0 && (r.first - cur.first) % r.step == 0)
+			{
+				//cur is split around r.
+				if (cur.last > r.last)
+				{
+					Range rest{after(cur, r.last), cur.last, cur.step};
+					settle(rest);
+					pending.push(rest);
+				}
+				if (cur.first < r.first)
+				{
+					cur.last = before(cur, r.first);
+					settle(cur);
+					merged.push_back(r);
+				}
+				else
+				{ cur = r; }
+			}
+			else
+			{
+				//The grids interleave: list the values both have from
+				//r.first to the end of the shorter one, keep the rests.
+				value_type stop = std::min(cur.last, r.last);
+				value_type mine = ongrid(cur, r.first) ? r.first : after(cur, r.first);
+				if (
+					(stop - r.first) / r.step
+					+ (mine <= stop ? (stop - mine) / cur.step : 0) >= maxlisted)
+				{ return false; }
+				if (r.last > stop)
+				{
+					Range rest{after(r, stop), r.last, r.step};
+					settle(rest);
+					pending.push(rest);
+				}
+				if (cur.last > stop)
+				{
+					Range rest{after(cur, stop), cur.last, cur.step};
+					settle(rest);
+					pending.push(rest);
+				}
+				listvalues(pending, r, r.first, stop);
+				if (mine <= stop) { listvalues(pending, cur, mine, stop); }
+				if (cur.first < r.first)
+				{
+					cur.last = before(cur, r.first);
+					settle(cur);
+				}
+				else
+				{ merged.pop_back(); }
+			}
+		}
+		ranges.swap(merged);
+		return true;
+	}
+
+	bool store(RangeList &dst, const char *arg)
+	{
+		std::vector<Range> ranges;
+		return split(arg, ranges) && dst.assign(std::move(ranges));
+	}
+
+	std::ostream& operator<<(std::ostream &o, const RangeList &list)
+	{
+		const char *sep = "";
+		for (const Range &r : list.intervals())
+		{
+			o << sep << r.first;
+			if (r.last != r.first) { o << '-' << r.last; }
+			if (r.step != 1) { o << ':' << r.step; }
+			sep = ",";
+		}
+		return o;
+	}
+}
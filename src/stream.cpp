@@ -0,0 +1,117 @@
+#include "argparse/stream.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace argparse
+{
+	Stream::Stream(int fd, char separator, std::size_t capacity):
+		fd(fd),
+		file(nullptr),
+		separator(separator),
+		buffer(capacity ? capacity + 1 : 2),
+		spare{},
+		begin(0),
+		end(0),
+		eof(false),
+		failed(false)
+	{}
+
+	Stream::Stream(std::FILE *file, char separator, std::size_t capacity):
+		fd(-1),
+		file(file),
+		separator(separator),
+		buffer(capacity ? capacity + 1 : 2),
+		spare{},
+		begin(0),
+		end(0),
+		eof(false),
+		failed(false)
+	{}
+
+	const char* Stream::next()
+	{
+		std::size_t searched = begin;
+		while (true)
+		{
+			char *data = buffer.data();
+			if (void *found = std::memchr(
+				data + searched, separator, end - searched))
+			{
+				char *stop = static_cast<char*>(found);
+				*stop = '\0';
+				const char *token = data + begin;
+				begin = stop - data + 1;
+				return token;
+			}
+			if (eof)
+			{
+				if (begin == end) { return nullptr; }
+				data[end] = '\0';
+				const char *token = data + begin;
+				begin = end;
+				return token;
+			}
+			searched = end - begin;
+			fill();
+		}
+	}
+
+	void Stream::fill()
+	{
+		std::size_t capacity = buffer.size() - 1;
+		if (begin)
+		{
+			//The returned token is before begin, leave it in place.  The
+			//spare buffer holds older tokens and can be overwritten.
+			if (spare.size() < buffer.size()) { spare.resize(buffer.size()); }
+			std::memcpy(spare.data(), buffer.data() + begin, end - begin);
+			buffer.swap(spare);
+			capacity = buffer.size() - 1;
+			end -= begin;
+			begin = 0;
+		}
+		else if (end == capacity)
+		{
+			buffer.resize(capacity * 2 + 1);
+			capacity *= 2;
+		}
+		char *dst = buffer.data() + end;
+		std::size_t size = capacity - end;
+		long got;
+		if (file)
+		{
+			got = static_cast<long>(std::fread(dst, 1, size, file));
+			if (!got)
+			{
+				eof = true;
+				failed = std::ferror(file) != 0;
+			}
+		}
+		else
+		{
+			do
+			{
+#ifdef _WIN32
+				got = ::_read(fd, dst, static_cast<unsigned>(size));
+#else
+				got = static_cast<long>(::read(fd, dst, size));
+#endif
+			} while (got < 0 && errno == EINTR);
+			//read errors end the input
+			if (got <= 0)
+			{
+				eof = true;
+				failed = got < 0;
+				got = 0;
+			}
+		}
+		end += static_cast<std::size_t>(got);
+	}
+}
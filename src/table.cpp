@@ -0,0 +1,173 @@
+#include "argparse/table.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace argparse
+{
+	namespace
+	{
+		const std::uint64_t basis = 0xcbf29ce484222325ull;
+		const std::uint64_t prime = 0x100000001b3ull;
+		const std::uint64_t golden = 0x9e3779b97f4a7c15ull;
+		//Displacement attempts per bucket before trying a new seed.
+		const std::uint32_t maxdisplace = 1u << 12;
+
+		inline std::uint64_t mix(std::uint64_t h)
+		{
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33;
+			h *= 0xc4ceb9fe1a85ec53ull;
+			h ^= h >> 33;
+			return h;
+		}
+
+		inline std::uint64_t finish(std::uint64_t h, std::size_t size)
+		{ return mix((h ^ size) * prime); }
+
+		inline std::uint64_t hash(
+			const char *name, std::size_t size, std::uint64_t seed)
+		{
+			std::uint64_t h = basis ^ seed;
+			for (std::size_t i=0; i<size; ++i)
+			{ h = (h ^ static_cast<unsigned char>(name[i])) * prime; }
+			return finish(h, size);
+		}
+
+		inline std::size_t bucket(std::uint64_t h, std::size_t mask)
+		{ return static_cast<std::size_t>(h >> 32) & mask; }
+
+		inline std::size_t place(
+			std::uint64_t h, std::uint32_t d, std::size_t mask)
+		{ return static_cast<std::size_t>(mix(h + d * golden)) & mask; }
+	}
+
+	NameTable::NameTable():
+		seed(0),
+		count(0),
+		bucketmask(0),
+		slotmask(0),
+		displace(1, 0),
+		slots(1, Entry{nullptr, npos, npos})
+	{}
+
+	void NameTable::clear()
+	{
+		seed = 0;
+		count = 0;
+		bucketmask = 0;
+		slotmask = 0;
+		displace.assign(1, 0);
+		slots.assign(1, Entry{nullptr, npos, npos});
+	}
+
+	void NameTable::build(const std::vector<const char*> &names)
+	{
+		clear();
+		if (names.empty()) { return; }
+		std::vector<std::size_t> sizes;
+		sizes.reserve(names.size());
+		for (const char *name : names) { sizes.push_back(std::strlen(name)); }
+
+		std::size_t nslots = 1;
+		while (nslots < 2 * names.size()) { nslots <<= 1; }
+		std::vector<std::uint64_t> hashes(names.size());
+		std::vector<std::size_t> order(names.size());
+		std::vector<std::size_t> placed;
+		std::vector<char> used;
+		for (std::uint64_t attempt = 1; ; ++attempt)
+		{
+			if (attempt % 8 == 0) { nslots <<= 1; }
+			std::size_t nbuckets = std::max<std::size_t>(1, nslots / 4);
+			std::uint64_t s = mix(attempt * golden);
+			for (std::size_t i=0; i<names.size(); ++i)
+			{
+				hashes[i] = hash(names[i], sizes[i], s);
+				order[i] = i;
+			}
+
+			//Group by bucket, largest buckets placed first.
+			std::vector<std::size_t> bsize(nbuckets, 0);
+			for (std::uint64_t h : hashes) { ++bsize[bucket(h, nbuckets-1)]; }
+			std::sort(
+				order.begin(), order.end(),
+				[&](std::size_t a, std::size_t b)
+				{
+					std::size_t ba = bucket(hashes[a], nbuckets-1);
+					std::size_t bb = bucket(hashes[b], nbuckets-1);
+					if (bsize[ba] != bsize[bb]) { return bsize[ba] > bsize[bb]; }
+					if (ba != bb) { return ba < bb; }
+					return hashes[a] < hashes[b];
+				});
+			bool ok = true;
+			for (std::size_t i=1; i<order.size() && ok; ++i)
+			{ ok = hashes[order[i]] != hashes[order[i-1]]; }
+			if (!ok) { continue; }
+
+			std::vector<std::uint32_t> disp(nbuckets, 0);
+			used.assign(nslots, 0);
+			for (std::size_t start=0; start<order.size() && ok;)
+			{
+				std::size_t b = bucket(hashes[order[start]], nbuckets-1);
+				std::size_t stop = start + bsize[b];
+				ok = false;
+				for (std::uint32_t d=0; d<maxdisplace && !ok; ++d)
+				{
+					placed.clear();
+					ok = true;
+					for (std::size_t i=start; i<stop && ok; ++i)
+					{
+						std::size_t slot = place(hashes[order[i]], d, nslots-1);
+						ok = !used[slot]
+							&& std::find(placed.begin(), placed.end(), slot) == placed.end();
+						placed.push_back(slot);
+					}
+					if (ok)
+					{
+						disp[b] = d;
+						for (std::size_t slot : placed) { used[slot] = 1; }
+					}
+				}
+				start = stop;
+			}
+			if (!ok) { continue; }
+
+			seed = s;
+			count = names.size();
+			bucketmask = nbuckets - 1;
+			slotmask = nslots - 1;
+			displace.swap(disp);
+			slots.assign(nslots, Entry{nullptr, npos, npos});
+			for (std::size_t i=0; i<names.size(); ++i)
+			{
+				std::uint64_t h = hashes[i];
+				std::size_t slot = place(h, displace[bucket(h, bucketmask)], slotmask);
+				slots[slot] = Entry{names[i], sizes[i], i};
+			}
+			return;
+		}
+	}
+
+	std::size_t NameTable::find(const char *name) const
+	{
+		std::uint64_t h = basis ^ seed;
+		std::size_t size = 0;
+		for (; name[size]; ++size)
+		{ h = (h ^ static_cast<unsigned char>(name[size])) * prime; }
+		return lookup(name, size, finish(h, size));
+	}
+
+	std::size_t NameTable::find(const char *name, std::size_t size) const
+	{ return lookup(name, size, hash(name, size, seed)); }
+
+	std::size_t NameTable::lookup(
+		const char *name, std::size_t size, std::uint64_t h) const
+	{
+		const Entry &entry = slots[
+			place(h, displace[bucket(h, bucketmask)], slotmask)];
+		if (entry.size == size && !std::memcmp(entry.name, name, size))
+		{ return entry.index; }
+		return npos;
+	}
+}
@@ -0,0 +1,174 @@
+#include "argparse/tokenize.hpp"
+
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define ARGPARSE_SSE2
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace argparse
+{
+	namespace
+	{
+		enum classes: unsigned char
+		{
+			space = 1,
+			squote = 2,
+			dquote = 4,
+			escape = 8,
+			//chars special outside of quotes
+			unquoted = space | squote | dquote | escape,
+			//chars special in double quotes
+			quoted = dquote | escape
+		};
+
+		struct Table
+		{
+			unsigned char cls[256];
+
+			Table():
+				cls{}
+			{
+				for (unsigned char c : {' ', '\t', '\n', '\v', '\f', '\r', '\0'})
+				{ cls[c] = space; }
+				cls[static_cast<unsigned char>('\'')] = squote;
+				cls[static_cast<unsigned char>('"')] = dquote;
+				cls[static_cast<unsigned char>('\\')] = escape;
+			}
+		};
+		const Table table;
+
+		inline unsigned char classify(char c)
+		{ return table.cls[static_cast<unsigned char>(c)]; }
+
+#ifdef ARGPARSE_SSE2
+		inline int firstbit(unsigned mask)
+		{
+#if defined(_MSC_VER)
+			unsigned long idx;
+			_BitScanForward(&idx, mask);
+			return static_cast<int>(idx);
+#else
+			return __builtin_ctz(mask);
+#endif
+		}
+
+		//Bits set for bytes in v of classes in mask.
+		inline unsigned specials(__m128i v, unsigned char mask)
+		{
+			__m128i hit = _mm_setzero_si128();
+			if (mask & space)
+			{
+				//'\t' to '\r' are 9-13.
+				__m128i ws = _mm_sub_epi8(v, _mm_set1_epi8(9));
+				hit = _mm_cmpeq_epi8(_mm_min_epu8(ws, _mm_set1_epi8(4)), ws);
+				hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+				hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+			}
+			if (mask & squote)
+			{ hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('\''))); }
+			if (mask & dquote)
+			{ hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('"'))); }
+			if (mask & escape)
+			{ hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))); }
+			return static_cast<unsigned>(_mm_movemask_epi8(hit));
+		}
+#endif
+
+		//Return the first char in [p, end) of a class in mask.
+		inline const char* scan(const char *p, const char *end, unsigned char mask)
+		{
+#ifdef ARGPARSE_SSE2
+			for (; end - p >= 16; p += 16)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				if (unsigned hits = specials(v, mask))
+				{ return p + firstbit(hits); }
+			}
+#endif
+			while (p < end && !(classify(*p) & mask)) { ++p; }
+			return p;
+		}
+
+		//Copy [in, stop) to out, return the new out.
+		inline char* copy(char *out, const char *in, const char *stop)
+		{
+			std::size_t size = stop - in;
+			if (out != in) { std::memmove(out, in, size); }
+			return out + size;
+		}
+	}
+
+	char* tokenize(char *begin, char *end)
+	{
+		char *out = begin;
+		const char *in = begin;
+		while (true)
+		{
+			while (in < end && classify(*in) & space) { ++in; }
+			if (in == end) { return out; }
+			while (in < end)
+			{
+				const char *stop = scan(in, end, unquoted);
+				out = copy(out, in, stop);
+				in = stop;
+				if (in == end || classify(*in) & space) { break; }
+				char c = *in++;
+				if (c == '\\')
+				{
+					if (in == end) { *out++ = c; }
+					else if (*in == '\n') { ++in; }
+					else { *out++ = *in++; }
+				}
+				else if (c == '\'')
+				{
+					stop = static_cast<const char*>(std::memchr(in, '\'', end - in));
+					if (!stop) { return nullptr; }
+					out = copy(out, in, stop);
+					in = stop + 1;
+				}
+				else
+				{
+					while (true)
+					{
+						stop = scan(in, end, quoted);
+						out = copy(out, in, stop);
+						in = stop;
+						if (in == end) { return nullptr; }
+						if (*in++ == '"') { break; }
+						//backslash
+						if (in == end) { return nullptr; }
+						char e = *in;
+						if (e == '\n') { ++in; }
+						else if (e == '$' || e == '`' || e == '"' || e == '\\')
+						{
+							*out++ = e;
+							++in;
+						}
+						else
+						{ *out++ = '\\'; }
+					}
+				}
+			}
+			*out++ = '\0';
+		}
+	}
+
+	int tokenize(char *line, const char **argv, int capacity)
+	{
+		char *end = tokenize(line, line + std::strlen(line));
+		if (!end) { return -1; }
+		int count = 0;
+		for (char *token = line; token < end; token += std::strlen(token) + 1)
+		{
+			if (count < capacity) { argv[count] = token; }
+			++count;
+		}
+		return count;
+	}
+}
@@ -0,0 +1,99 @@
+#include "argparse/trie.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace argparse
+{
+	PrefixTrie::PrefixTrie():
+		nodes(1, Node{nullptr, 0, 0, 0, npos})
+	{}
+
+	void PrefixTrie::clear()
+	{ nodes.assign(1, Node{nullptr, 0, 0, 0, npos}); }
+
+	void PrefixTrie::build(
+		const std::vector<const char*> &names,
+		const std::vector<std::size_t> &values)
+	{
+		clear();
+		if (names.empty()) { return; }
+		std::vector<Item> items;
+		items.reserve(names.size());
+		for (std::size_t i=0; i<names.size(); ++i)
+		{ items.push_back(Item{names[i], std::strlen(names[i]), values[i]}); }
+		std::sort(
+			items.begin(), items.end(),
+			[](const Item &a, const Item &b)
+			{ return std::strcmp(a.name, b.name) < 0; });
+		nodes.reserve(2 * items.size());
+		fill(0, items, 0, items.size(), 0);
+	}
+
+	//items[lo, hi) are the names below node, which matched depth chars.
+	//Create the children of node contiguously, then fill each child.
+	void PrefixTrie::fill(
+		std::size_t node, const std::vector<Item> &items,
+		std::size_t lo, std::size_t hi, std::size_t depth)
+	{
+		std::size_t value = items[lo].value;
+		for (std::size_t i=lo+1; i<hi && value != ambiguous; ++i)
+		{ if (items[i].value != value) { value = ambiguous; } }
+		nodes[node].value = value;
+
+		//A name ending here sorts first and has no children.
+		if (items[lo].size == depth) { ++lo; }
+		std::size_t first = nodes.size();
+		std::vector<std::size_t> bounds;
+		for (std::size_t start=lo; start<hi;)
+		{
+			char c = items[start].name[depth];
+			std::size_t stop = start + 1;
+			while (stop < hi && items[stop].name[depth] == c) { ++stop; }
+			//Sorted, so the group's common prefix is that of its ends.
+			const char *a = items[start].name;
+			const char *b = items[stop-1].name;
+			std::size_t common = depth + 1;
+			while (a[common] && a[common] == b[common]) { ++common; }
+			nodes.push_back(
+				Node{a + depth, common - depth, 0, 0, npos});
+			bounds.push_back(start);
+			bounds.push_back(stop);
+			bounds.push_back(common);
+			start = stop;
+		}
+		nodes[node].first = static_cast<std::uint32_t>(first);
+		nodes[node].count = static_cast<std::uint32_t>(nodes.size() - first);
+		for (std::size_t i=0; i<bounds.size(); i+=3)
+		{ fill(first + i / 3, items, bounds[i], bounds[i+1], bounds[i+2]); }
+	}
+
+	std::size_t PrefixTrie::find(const char *prefix) const
+	{ return find(prefix, std::strlen(prefix)); }
+
+	std::size_t PrefixTrie::find(const char *prefix, std::size_t size) const
+	{
+		if (!size) { return npos; }
+		const Node *node = &nodes[0];
+		std::size_t pos = 0;
+		while (pos < size)
+		{
+			//leaves have no children, first is one past the end
+			if (!node->count) { return npos; }
+			const Node *begin = &nodes[node->first];
+			const Node *end = begin + node->count;
+			unsigned char c = static_cast<unsigned char>(prefix[pos]);
+			const Node *child = std::lower_bound(
+				begin, end, c,
+				[](const Node &n, unsigned char c)
+				{ return static_cast<unsigned char>(n.label[0]) < c; });
+			if (child == end || static_cast<unsigned char>(child->label[0]) != c)
+			{ return npos; }
+			std::size_t n = std::min(child->size, size - pos);
+			if (std::memcmp(child->label, prefix + pos, n)) { return npos; }
+			pos += n;
+			node = child;
+		}
+		return node->value;
+	}
+}
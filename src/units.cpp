@@ -0,0 +1,162 @@
+#include "argparse/units.hpp"
+#include "lex.hpp"
+
+#include <cstring>
+#include <limits>
+
+namespace argparse
+{
+	namespace
+	{
+		typedef unsigned long long ull;
+
+		using lex::isspace;
+
+		//Skip whitespace and read the digits.  Return the start of the
+		//suffix or nullptr if there are no digits or they overflow.
+		const char* whole(const char *p, ull &out)
+		{
+			while (isspace(*p)) { ++p; }
+			const char *end = lex::decimal<std::numeric_limits<ull>::max()>(p, out);
+			return end != p ? end : nullptr;
+		}
+
+		//Find the length of the suffix at p.  False if anything but
+		//whitespace follows it.
+		bool suffix(const char *p, std::size_t &size)
+		{
+			size = 0;
+			while (p[size] && !isspace(p[size])) { ++size; }
+			const char *end = p + size;
+			while (isspace(*end)) { ++end; }
+			return !*end;
+		}
+
+		inline bool scale(ull value, ull unit, ull limit, ull &out)
+		{
+			if (value > limit / unit) { return false; }
+			out = value * unit;
+			return true;
+		}
+
+		//Power of the size unit letter, 0 if not a unit.
+		struct PowerTable
+		{ unsigned char power[256]; };
+
+		constexpr PowerTable makepowers()
+		{
+			PowerTable table{};
+			const char letters[] = "KMGTPE";
+			for (unsigned i=0; letters[i]; ++i)
+			{ table.power[static_cast<unsigned char>(letters[i])] = i + 1; }
+			table.power[static_cast<unsigned char>('k')] = 1;
+			return table;
+		}
+
+		constexpr PowerTable sizepowers = makepowers();
+		const char sizeletters[] = "KMGTPE";
+
+		struct Unit
+		{
+			const char *name;
+			std::size_t size;
+			ull nanos;
+		};
+
+		//Largest first for printing.
+		constexpr Unit timeunits[] = {
+			{"d", 1, 86400000000000ull},
+			{"h", 1, 3600000000000ull},
+			{"m", 1, 60000000000ull},
+			{"s", 1, 1000000000ull},
+			{"ms", 2, 1000000ull},
+			{"us", 2, 1000ull},
+			{"ns", 2, 1ull},
+		};
+	}
+
+	bool store(Size &dst, const char *arg)
+	{
+		ull value;
+		const char *p = whole(arg, value);
+		std::size_t size;
+		if (!p || !suffix(p, size)) { return false; }
+		ull unit = 1;
+		if (size && !(size == 1 && p[0] == 'B'))
+		{
+			unsigned power = sizepowers.power[static_cast<unsigned char>(p[0])];
+			if (!power) { return false; }
+			ull base;
+			if (size == 1 || (size == 3 && p[1] == 'i' && p[2] == 'B'))
+			{ base = 1024; }
+			else if (size == 2 && p[1] == 'B')
+			{ base = 1000; }
+			else
+			{ return false; }
+			for (; power; --power) { unit *= base; }
+		}
+		if (!scale(value, unit, std::numeric_limits<ull>::max(), value))
+		{ return false; }
+		dst.data = value;
+		return true;
+	}
+
+	bool store(Duration &dst, const char *arg)
+	{
+		typedef std::chrono::nanoseconds::rep rep;
+		while (isspace(*arg)) { ++arg; }
+		//negative durations print with a sign, so they parse with one
+		bool negative = *arg == '-';
+		if (negative && isspace(*++arg)) { return false; }
+		ull value;
+		const char *p = whole(arg, value);
+		std::size_t size;
+		if (!p || !suffix(p, size)) { return false; }
+		ull unit = size ? 0 : 1000000000ull;
+		for (const Unit &u : timeunits)
+		{
+			if (u.size == size && !std::memcmp(u.name, p, size))
+			{ unit = u.nanos; }
+		}
+		const ull limit =
+			static_cast<ull>(std::numeric_limits<rep>::max()) + negative;
+		if (!unit || !scale(value, unit, limit, value)) { return false; }
+		//-(value - 1) - 1 reaches the minimum without overflowing
+		dst.data = std::chrono::nanoseconds(
+			negative && value
+				? -static_cast<rep>(value - 1) - 1 : static_cast<rep>(value));
+		return true;
+	}
+
+	std::ostream& operator<<(std::ostream &o, const Size &size)
+	{
+		ull value = size.data;
+		unsigned power = 0;
+		while (value && power < sizeof(sizeletters) - 1 && !(value % 1024))
+		{
+			value /= 1024;
+			++power;
+		}
+		o << value;
+		if (power) { o << sizeletters[power-1]; }
+		return o;
+	}
+
+	std::ostream& operator<<(std::ostream &o, const Duration &duration)
+	{
+		auto count = duration.data.count();
+		ull value = static_cast<ull>(count);
+		if (count < 0)
+		{
+			o << '-';
+			value = 0 - value;
+		}
+		if (!value) { return o << "0s"; }
+		for (const Unit &u : timeunits)
+		{
+			if (!(value % u.nanos))
+			{ return o << value / u.nanos << u.name; }
+		}
+		return o;
+	}
+}
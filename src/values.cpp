@@ -0,0 +1,73 @@
+#include "argparse/argparse.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace argparse
+{
+	Values::Values(
+		const Parser &parser, std::pmr::memory_resource *resource
+	):
+		parser(parser),
+		buffer{},
+		slots{},
+		dirty(false)
+	{
+		if (!parser.frozen) { parser.freeze(); }
+		std::size_t words = (parser.slotbytes + sizeof(std::max_align_t) - 1)
+			/ sizeof(std::max_align_t);
+		buffer.reset(new std::max_align_t[words ? words : 1]);
+		char *base = reinterpret_cast<char*>(buffer.get());
+		slots.reserve(parser.args.size());
+		try
+		{
+			for (ArgCommon *arg : parser.args)
+			{
+				std::size_t offset = parser.slotoffsets[slots.size()];
+				if (offset == static_cast<std::size_t>(-1))
+				{
+					throw std::logic_error(
+						"Arg does not support Values: " + std::string(arg->names[0]));
+				}
+				arg->slot_init(base + offset, resource);
+				slots.push_back(base + offset);
+			}
+		}
+		catch (...)
+		{
+			while (slots.size())
+			{
+				parser.args[slots.size()-1]->slot_free(slots.back());
+				slots.pop_back();
+			}
+			throw;
+		}
+	}
+
+	Values::~Values()
+	{
+		for (std::size_t idx=0; idx<slots.size(); ++idx)
+		{ parser.args[idx]->slot_free(slots[idx]); }
+	}
+
+	void Values::reset()
+	{
+		for (std::size_t idx=0; idx<slots.size(); ++idx)
+		{ parser.args[idx]->slot_reset(slots[idx]); }
+		dirty = false;
+	}
+
+	void* Values::slot(const ArgCommon &arg)
+	{
+		if (arg.id >= slots.size() || parser.args[arg.id] != &arg)
+		{ throw std::logic_error("Arg does not belong to the parser."); }
+		return slots[arg.id];
+	}
+
+	const void* Values::slot(const ArgCommon &arg) const
+	{
+		if (arg.id >= slots.size() || parser.args[arg.id] != &arg)
+		{ throw std::logic_error("Arg does not belong to the parser."); }
+		return slots[arg.id];
+	}
+}
@@ -3,9 +3,17 @@
 #include "argparse/argiter.hpp"
 #include <cstdarg>
 #include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
 #include <vector>
 #include <cassert>
 
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 int main(int argc, char *argv[])
 {
@@ -129,5 +137,111 @@ int main(int argc, char *argv[])
 		assert(!it);
 	}
 
+	{
+		using namespace argparse;
+		std::ofstream("argiter_outer.rsp")
+			<< "  -v 'single quoted' \"double \\\"quoted\\\"\"\n"
+			<< "\t@argiter_inner.rsp esc\\ aped\n";
+		std::ofstream("argiter_inner.rsp") << "--flag2 inner";
+		//exactly a page: no spare byte in a mapping
+		std::ofstream("argiter_page.rsp") << std::string(4095, 'x') << ' ';
+		std::ofstream("argiter_empty.rsp");
+
+		const char *args[] = {
+			"first", "@argiter_outer.rsp", "@argiter_missing.rsp", "@",
+			"@argiter_empty.rsp", "@argiter_page.rsp", "--1",
+			"@argiter_inner.rsp", "last"
+		};
+		ArgIter it(args, "-", '@');
+		assert(!std::strcmp(it.arg, "first"));
+		it.step();
+		assert(it.isflag == 1);
+		assert(!std::strcmp(it.arg, "v"));
+		assert(it.index() == 1);
+		it.step();
+		assert(!std::strcmp(it.arg, "single quoted"));
+		ArgIter saved(it);
+		it.step();
+		assert(!std::strcmp(it.arg, "double \"quoted\""));
+		it.step();
+		assert(it.isflag == 2);
+		assert(!std::strcmp(it.arg, "flag2"));
+		assert(it.index() == 1);
+		it.step();
+		assert(!std::strcmp(it.arg, "inner"));
+		it.step();
+		assert(!std::strcmp(it.arg, "esc aped"));
+		it.step();
+		assert(!std::strcmp(it.arg, "@argiter_missing.rsp"));
+		assert(it.index() == 2);
+		it.step();
+		assert(!std::strcmp(it.arg, "@"));
+		it.step();
+		assert(it.arg == std::string(4095, 'x'));
+		assert(it.index() == 5);
+		it.step();
+		assert(!std::strcmp(it.arg, "@argiter_inner.rsp"));
+		assert(!it.isflag);
+		it.step();
+		assert(!std::strcmp(it.arg, "last"));
+		it.step();
+		assert(!it);
+
+		it = saved;
+		assert(!std::strcmp(it.arg, "single quoted"));
+		it.step();
+		assert(!std::strcmp(it.arg, "double \"quoted\""));
+
+		ArgIter plain(args, "-");
+		plain.step();
+		assert(!std::strcmp(plain.arg, "@argiter_outer.rsp"));
+		assert(!plain.storage());
+	}
+	{
+		using namespace argparse;
+		//an open file is not expanded again
+		std::ofstream("argiter_self.rsp") << "real @argiter_self.rsp";
+		const char *args[] = {"@argiter_self.rsp"};
+		ArgIter it(args, "-", '@');
+		assert(!std::strcmp(it.arg, "real"));
+		it.step();
+		assert(!std::strcmp(it.arg, "@argiter_self.rsp"));
+		it.step();
+		assert(!it);
+
+		std::ofstream("argiter_ping.rsp") << "ping @argiter_pong.rsp";
+		std::ofstream("argiter_pong.rsp") << "pong @argiter_ping.rsp";
+		const char *cycle[] = {"@argiter_ping.rsp", "@argiter_ping.rsp"};
+		ArgIter loop(cycle, "-", '@');
+		for (const char *expect : {
+			"ping", "pong", "@argiter_ping.rsp", "ping", "pong",
+			"@argiter_ping.rsp"})
+		{
+			assert(!std::strcmp(loop.arg, expect));
+			loop.step();
+		}
+		assert(!loop);
+	}
+#ifndef _WIN32
+	{
+		using namespace argparse;
+		//pipes have no size and are read until EOF
+		::unlink("argiter_fifo.rsp");
+		assert(!::mkfifo("argiter_fifo.rsp", 0600));
+		std::string big(10000, 'y');
+		std::thread writer(
+			[&big]() { std::ofstream("argiter_fifo.rsp") << "fifo " << big; });
+		const char *args[] = {"@argiter_fifo.rsp"};
+		ArgIter it(args, "-", '@');
+		writer.join();
+		assert(!std::strcmp(it.arg, "fifo"));
+		it.step();
+		assert(it.arg == big);
+		it.step();
+		assert(!it);
+		::unlink("argiter_fifo.rsp");
+	}
+#endif
+
 	return 0;
 }
@@ -3,8 +3,11 @@
 #include "argparse/argparse.hpp"
 #include "argparse/argiter.hpp"
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <sstream>
 
@@ -108,6 +111,20 @@ int repeat_flag(const char *prog)
 	}
 	catch(std::logic_error &e)
 	{}
+
+	try
+	{
+		Flag<int> f3(p, {"flag3", "flag1"}, "names are rolled back", {});
+		assert(false);
+	}
+	catch(std::logic_error &e)
+	{}
+	Flag<int> f3(p, "flag3", "third flag", 3);
+	const char *args[] = {"--flag3", "5", "--flag1", "6"};
+	auto result = p.parse(args, prog);
+	assert(result.code == result.success);
+	assert(*f1 == 6);
+	assert(*f3 == 5);
 	return 0;
 }
 
@@ -140,6 +157,30 @@ namespace custom_namespace
 	{
 		return parse(out.x, it) && parse(out.y, it);
 	}
+
+	//Copies a string after the iterator has stepped past it.
+	struct Copied { std::string text; };
+	int parse(Copied &out, argparse::ArgIter &it)
+	{
+		const char *text;
+		if (!argparse::parse(text, it)) { return 0; }
+		out.text = text;
+		return 1;
+	}
+
+	//Consumes values as they are parsed instead of storing them.
+	struct Total { long sum; int count; };
+	int parse(Total &out, argparse::ArgIter &it)
+	{
+		out = Total{0, 0};
+		int value;
+		while (it && parse(value, it))
+		{
+			out.sum += value;
+			++out.count;
+		}
+		return 1;
+	}
 }
 
 int custom(const char *prog)
@@ -259,6 +300,863 @@ int full(const char *prog)
 	return 0;
 }
 
+int singlepass(const char *prog)
+{
+	using namespace argparse;
+	std::stringstream ss;
+	Parser p("single pass", '-', ss);
+	p.singlepass = true;
+	Arg<int> num(p, "num", "A number, required");
+	Flag<float, 3> vec(p, {"vec", "v"}, "Vector x y z", {});
+
+	{
+		const char *args[] = {"-h"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.help);
+		assert(ss.str().find("Usage: ") == 0);
+	}
+	{
+		ss.str("");
+		const char *args[] = {"not an int", "--vec", "1", "--help"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.help);
+		assert(!result.parsed(num));
+		assert(ss.str().find("Error") == std::string::npos);
+		assert(ss.str().find("Flags:") != std::string::npos);
+	}
+	{
+		ss.str("");
+		const char *args[] = {"--vec", "1", "-h"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.help);
+		assert(ss.str().find("Error") == std::string::npos);
+	}
+	{
+		ss.str("");
+		const char *args[] = {"--vec", "1", "2", "x", "--", "-h"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.error);
+		assert(ss.str() == "Error parsing flag \"--vec\"\n");
+	}
+	{
+		ss.str("");
+		const char *args[] = {"-v", "1", "2", "3"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.missing);
+		assert(ss.str() == "Missing required positional argument \"num\"\n");
+	}
+	{
+		ss.str("");
+		const char *args[] = {"5", "-v", "1", "2", "3"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.success);
+		assert(*num == 5);
+		assert(vec[2] == 3);
+		assert(ss.str().empty());
+	}
+	return 0;
+}
+
+int many(const char *prog)
+{
+	using namespace argparse;
+	Parser p("many flags");
+	Parser other("other parser");
+	std::vector<std::string> names;
+	for (int i=0; i<300; ++i) { names.push_back("flag" + std::to_string(i)); }
+	std::vector<std::unique_ptr<Flag<int>>> flags;
+	for (auto &name : names)
+	{ flags.emplace_back(new Flag<int>(p, name.c_str(), nullptr, 0)); }
+	Flag<int> foreign(other, "flag299", nullptr, 0);
+	assert(foreign.id == flags[0]->id);
+
+	const char *args[] = {"--flag0", "1", "--flag299", "2", "--flag150", "3"};
+	auto result = p.parse(args, prog);
+	assert(result.code == result.success);
+	for (std::size_t i=0; i<flags.size(); ++i)
+	{ assert(result.parsed(*flags[i]) == (i == 0 || i == 150 || i == 299)); }
+	assert(!result.parsed(foreign));
+	assert(**flags[299] == 2);
+
+	auto copy = result;
+	assert(copy.parsed(*flags[150]));
+
+	std::stringstream ss;
+	Parser req("required flags", '-', ss);
+	std::vector<std::unique_ptr<Flag<int>>> reqs;
+	for (auto &name : names)
+	{ reqs.emplace_back(new Flag<int>(req, name.c_str(), nullptr)); }
+	const char *none[] = {"--flag7", "1"};
+	result = req.parse(none, prog);
+	assert(result.code == result.missing);
+	assert(ss.str() == "Missing required flag \"--flag0\"\n");
+	std::vector<std::string> all;
+	for (auto &name : names)
+	{
+		all.push_back("--" + name);
+		all.push_back("1");
+	}
+	std::vector<const char*> allargs;
+	for (auto &arg : all) { allargs.push_back(arg.c_str()); }
+	result = req.parse(allargs.size(), &allargs[0], prog);
+	assert(result.code == result.success);
+	return 0;
+}
+
+int reuse(const char *prog)
+{
+	using namespace argparse;
+	Parser p("reuse parser");
+	Flag<bool, 0> toggle(p, "t", "toggle");
+	Flag<bool> count(p, "c", "count", 2);
+	Flag<int, -1> nums(p, "nums", "numbers", {{1, 2}});
+	Aflag<int> appended(p, "a", "appended", {7, 8});
+	Aflag<bool> counts(p, "v", "appended counts");
+	Arg<const char*, -2> rest(p, "rest", "remaining args");
+
+	const char *first[] = {
+		"-tcc", "--nums", "3", "4", "5", "-a1", "-a2", "-vv", "x", "y"};
+	const char *second[] = {"-a3"};
+	for (int i=0; i<2; ++i)
+	{
+		auto result = p.parse(first, prog);
+		assert(result.code == result.success);
+		assert(*toggle);
+		assert(*count == 4);
+		assert(nums->size() == 3 && nums[2] == 5);
+		assert(appended->size() == 2 && appended[1] == 2);
+		assert((*counts == std::vector<int>{1, 2}));
+		assert(rest->arg && !std::strcmp(rest->arg, "x"));
+		auto capacity = nums->capacity();
+		p.reset();
+		assert(!*toggle);
+		assert(*count == 2);
+		assert(nums->size() == 2 && nums[0] == 1 && nums[1] == 2);
+		assert(nums->capacity() == capacity);
+		assert(appended->size() == 2 && appended[0] == 7 && appended[1] == 8);
+		assert(!*rest);
+	}
+	auto result = p.parse(second, prog);
+	assert(result.code == result.success);
+	assert(appended->size() == 1 && appended[0] == 3);
+	return 0;
+}
+
+int clusters(const char *prog)
+{
+	using namespace argparse;
+	Parser p("short flag clusters");
+	Flag<bool> verbose(p, {"v", "verbose"}, "verbosity");
+	Flag<bool, 0> quiet(p, "q", "toggle quiet");
+	Flag<int> num(p, "n", "a number", 0);
+
+	{
+		const char *args[] = {"-vvvvqqq", "-vn42", "-qq"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.success);
+		assert(*verbose == 5);
+		assert(*quiet);
+		assert(*num == 42);
+		assert(result.parsed(verbose));
+		assert(result.parsed(quiet));
+		assert(result.parsed(num));
+	}
+	{
+		const char *args[] = {"-vvx"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.unknown);
+		assert(*verbose == 7);
+	}
+	{
+		const char *args[] = {"-nn"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.error);
+	}
+	{
+		//appended flags record every occurrence of a run
+		Parser ap("appended clusters");
+		Aflag<bool> counts(ap, "a", "appended counts");
+		const char *args[] = {"-aaa"};
+		auto result = ap.parse(args, prog);
+		assert(result.code == result.success);
+		assert((*counts == std::vector<int>{1, 2, 3}));
+	}
+	return 0;
+}
+
+int help(const char *prog)
+{
+	using namespace argparse;
+	std::stringstream ss;
+	Parser p("help text", '-', ss);
+	Group g(p, "Grouped");
+	Arg<int> num(p, "name", "A number");
+	Flag<int> level(g, {"l", "level"}, "A level", 3);
+	Arg<int> other(g, "name", "Same name", 2);
+	{
+		const char *args[] = {"-h"};
+		assert(p.parse(args, "prog").code == ParseResult::help);
+		assert(ss.str() == "Usage: prog [-l x1] <name> [name]\n");
+	}
+	{
+		ss.str("");
+		const char *args[] = {"--help"};
+		assert(p.parse(args, "prog").code == ParseResult::help);
+		assert(ss.str() ==
+			"repeated arg: name\n"
+			"Usage: prog [-l x1] <name> [name]\n"
+			"\nhelp text\n"
+			"\nGrouped args:\n"
+			"  Flags:\n"
+			"    [-l | --level] Default: 3\n"
+			"      A level\n"
+			"  Positional Arguments:\n"
+			"    [name] (Positional index 1) Default: 2\n"
+			"      Same name\n"
+			"\nPositional Arguments:\n"
+			"  <name> (Positional index 0)\n"
+			"    A number\n");
+	}
+	{
+		//adding args renders the help again
+		Flag<bool, 0> toggle(p, "t", "toggle");
+		ss.str("");
+		const char *args[] = {"-h"};
+		assert(p.parse(args, "prog").code == ParseResult::help);
+		assert(ss.str() == "Usage: prog [-l x1] [-t !!] <name> [name]\n");
+	}
+	return 0;
+}
+
+int failures(const char *prog)
+{
+	using namespace argparse;
+	typedef ParseResult::Error Error;
+	std::stringstream ss;
+	Parser p("failures", '-', ss);
+	p.quiet = true;
+	Arg<int> num(p, "num", "A number");
+	Flag<float, 3> vec(p, {"vec", "v"}, "Vector x y z", {});
+	Flag<int> req(p, "req", "required");
+	{
+		const char *args[] = {"1", "--req", "2"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.success);
+		assert(result.failure.kind == Error::none);
+		assert(result.failure.message().empty());
+	}
+	{
+		const char *args[] = {"1", "--req", "2", "--bad"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.unknown);
+		assert(result.failure.kind == Error::unknown_flag);
+		assert(result.failure.index == 3);
+		assert(result.failure.name == args[3] + 2);
+		assert(!result.failure.arg);
+		assert(result.failure.message() == "Unknown flag \"--bad\"");
+	}
+	{
+		const char *args[] = {"1", "--req", "2", "-v", "1", "x"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.error);
+		assert(result.failure.kind == Error::bad_flag);
+		assert(result.failure.index == 3);
+		assert(result.failure.arg == &vec);
+		assert(result.failure.expected == 3);
+		assert(result.failure.message() == "Error parsing flag \"-v\"");
+	}
+	{
+		const char *args[] = {"--req", "2", "x"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.error);
+		assert(result.failure.kind == Error::bad_positional);
+		assert(result.failure.index == 2);
+		assert(result.failure.arg == &num);
+		assert(result.failure.expected == 1);
+	}
+	{
+		const char *args[] = {"--req", "2", "1", "extra"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.unknown);
+		assert(result.failure.kind == Error::unknown_arg);
+		assert(result.failure.index == 3);
+	}
+	{
+		const char *args[] = {"--req", "2"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.missing);
+		assert(result.failure.kind == Error::missing_positional);
+		assert(result.failure.index == -1);
+		assert(result.failure.arg == &num);
+	}
+	{
+		const char *args[] = {"1"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.missing);
+		assert(result.failure.kind == Error::missing_flag);
+		assert(result.failure.arg == &req);
+		std::stringstream msg;
+		msg << result.failure;
+		assert(msg.str() == "Missing required flag \"--req\"");
+	}
+	assert(ss.str().empty());
+	p.quiet = false;
+	{
+		const char *args[] = {"1"};
+		p.parse(args, prog);
+		assert(ss.str() == "Missing required flag \"--req\"\n");
+	}
+	return 0;
+}
+
+struct Build: public argparse::Parser
+{
+	static int made;
+	argparse::Arg<int> jobs;
+	argparse::Flag<bool, 0> fast;
+
+	Build(std::ostream &out):
+		Parser("build things", '-', out),
+		jobs(*this, "jobs", "number of jobs"),
+		fast(*this, "fast", "go fast")
+	{ ++made; }
+};
+int Build::made = 0;
+
+struct Clean: public argparse::Parser
+{
+	static int made;
+	Clean() { ++made; }
+};
+int Clean::made = 0;
+
+int subcommands(const char *prog)
+{
+	using namespace argparse;
+	std::stringstream ss;
+	Parser p("tool", '-', ss);
+	Flag<bool> verbose(p, "v", "verbosity");
+	p.subcommand(
+		"build", "build it",
+		[&ss]() { return std::unique_ptr<Parser>(new Build(ss)); });
+	p.subcommand<Clean>("clean");
+	try
+	{
+		p.subcommand<Clean>("clean");
+		assert(false);
+	}
+	catch (std::logic_error&)
+	{}
+	{
+		const char *args[] = {"-vv", "build", "4", "--fast"};
+		auto result = p.parse(args, "prog");
+		assert(result.code == result.success);
+		assert(verbose == 2);
+		assert(result.subcommand);
+		assert(!std::strcmp(result.subcommand->name, "build"));
+		Build &build = result.subcommand->get<Build>();
+		assert(*build.jobs == 4);
+		assert(build.fast);
+		assert(result.subcommand->result.parsed(build.jobs));
+		assert(Build::made == 1 && Clean::made == 0);
+	}
+	p.reset();
+	{
+		const char *args[] = {"clean"};
+		auto result = p.parse(args, "prog");
+		assert(result.code == result.success);
+		assert(!std::strcmp(result.subcommand->name, "clean"));
+		assert(Build::made == 1 && Clean::made == 1);
+	}
+	{
+		const char *args[] = {"-v"};
+		auto result = p.parse(args, "prog");
+		assert(result.code == result.success);
+		assert(!result.subcommand);
+	}
+	{
+		ss.str("");
+		const char *args[] = {"build", "-h"};
+		auto result = p.parse(args, "prog");
+		assert(result.code == result.help);
+		assert(ss.str() == "Usage: prog build [--fast !!] <jobs>\n");
+	}
+	{
+		//Clean prints to std::cerr on its own
+		ss.str("");
+		const char *args[] = {"clean", "-h"};
+		auto result = p.parse(args, "prog");
+		assert(result.code == result.help);
+		assert(ss.str() == "Usage: prog clean\n");
+	}
+	{
+		ss.str("");
+		const char *args[] = {"-h"};
+		auto result = p.parse(args, "prog");
+		assert(result.code == result.help);
+		assert(ss.str() == "Usage: prog [-v ++] <command> ...\n");
+		ss.str("");
+		const char *full[] = {"--help"};
+		p.parse(full, "prog");
+		assert(ss.str().find("Commands:\n  build\n    build it\n  clean\n") != std::string::npos);
+	}
+	{
+		ss.str("");
+		const char *args[] = {"-v", "build", "x"};
+		auto result = p.parse(args, "prog");
+		assert(result.code == result.error);
+		assert(result.failure.kind == ParseResult::Error::bad_positional);
+		assert(result.failure.index == 2);
+		assert(ss.str() == "Error parsing positional \"jobs\"\n");
+	}
+	{
+		//a quiet parent silences its subcommands' errors, not their help
+		ss.str("");
+		p.quiet = true;
+		const char *args[] = {"build", "x"};
+		auto result = p.parse(args, "prog");
+		assert(result.code == result.error);
+		assert(result.failure.kind == ParseResult::Error::bad_positional);
+		assert(ss.str().empty());
+		const char *help[] = {"build", "-h"};
+		assert(p.parse(help, "prog").code == ParseResult::help);
+		assert(ss.str() == "Usage: prog build [--fast !!] <jobs>\n");
+		p.quiet = false;
+	}
+	{
+		ss.str("");
+		const char *args[] = {"nope"};
+		auto result = p.parse(args, "prog");
+		assert(result.code == result.unknown);
+		assert(ss.str() == "Unknown argument \"nope\"\n");
+	}
+	{
+		//factories must build a parser
+		p.subcommand("broken", "no parser", []() { return nullptr; });
+		const char *args[] = {"broken"};
+		try
+		{
+			p.parse(args, "prog");
+			assert(false);
+		}
+		catch (std::logic_error&)
+		{}
+		try
+		{
+			p.subcommand("empty", "no factory", nullptr);
+			assert(false);
+		}
+		catch (std::logic_error&)
+		{}
+	}
+	return 0;
+}
+
+int abbreviations(const char *prog)
+{
+	using namespace argparse;
+	std::stringstream ss;
+	Parser p("abbreviations", '-', ss);
+	Flag<bool> verbose(p, {"v", "verbose"}, "verbosity");
+	Flag<const char*> version(p, "version", "a version", "1");
+	Flag<int> level(p, "level", "a level", 0);
+	{
+		const char *args[] = {"--verb"};
+		assert(p.parse(args, prog).code == ParseResult::unknown);
+	}
+	p.abbreviate = true;
+	p.reset();
+	ss.str("");
+	{
+		const char *args[] = {"--verb", "--verbo", "--v", "--vers", "2", "--l", "3"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.success);
+		assert(verbose == 3);
+		assert(!std::strcmp(*version, "2"));
+		assert(*level == 3);
+	}
+	{
+		const char *args[] = {"--ver"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.unknown);
+		assert(result.failure.kind == ParseResult::Error::ambiguous_flag);
+		assert(ss.str() == "Ambiguous flag \"--ver\"\n");
+	}
+	{
+		ss.str("");
+		const char *args[] = {"--levle"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.unknown);
+		assert(!std::strcmp(result.failure.suggestions[0], "level"));
+		assert(!result.failure.suggestions[1]);
+		assert(ss.str() == "Unknown flag \"--levle\", did you mean \"--level\"?\n");
+	}
+	{
+		ss.str("");
+		const char *args[] = {"--verzion"};
+		auto result = p.parse(args, prog);
+		assert(!std::strcmp(result.failure.suggestions[0], "version"));
+		assert(!result.failure.suggestions[1]);
+	}
+	{
+		ss.str("");
+		const char *args[] = {"--lev", "x"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.error);
+		assert(result.failure.arg == &level);
+		assert(ss.str() == "Error parsing flag \"--lev\"\n");
+	}
+	{
+		//aliases of one flag are suggested once
+		Parser q("aliases", '-', ss);
+		Flag<bool> verbose(q, {"verbose", "verbos", "v"}, "verbosity");
+		ss.str("");
+		const char *args[] = {"--verbse"};
+		auto result = q.parse(args, prog);
+		assert(result.code == result.unknown);
+		assert(!std::strcmp(result.failure.suggestions[0], "verbose"));
+		assert(!result.failure.suggestions[1]);
+	}
+	{
+		//an exact --help is not taken as a prefix of --helper
+		Parser q("helpers", '-', ss);
+		Flag<bool> helper(q, "helper", "a helper");
+		q.abbreviate = true;
+		q.singlepass = true;
+		ss.str("");
+		const char *args[] = {"--help"};
+		assert(q.parse(args, prog).code == ParseResult::help);
+		assert(!helper);
+		assert(ss.str().find("--helper") != std::string::npos);
+		const char *prefix[] = {"--help", "--he"};
+		assert(q.parse(prefix, prog).code == ParseResult::help);
+		const char *abbrev[] = {"--he"};
+		assert(q.parse(abbrev, prog).code == ParseResult::success);
+		assert(helper == 1);
+	}
+	return 0;
+}
+
+int responsefiles(const char *prog)
+{
+	using namespace argparse;
+	std::stringstream ss;
+	Parser p("response files", '-', ss);
+	Flag<const char*> name(p, "name", "a name", "none");
+	Arg<int> count(p, "count", "a count");
+	std::ofstream("argparse_args.rsp") << "--name 'from file'\n3\n";
+	{
+		const char *args[] = {"@argparse_args.rsp"};
+		assert(p.parse(args, prog).code == ParseResult::error);
+	}
+	p.responsefiles = true;
+	p.reset();
+	ParseResult result;
+	{
+		const char *args[] = {"@argparse_args.rsp"};
+		result = p.parse(args, prog);
+	}
+	assert(result.code == result.success);
+	assert(result.storage);
+	assert(!std::strcmp(*name, "from file"));
+	assert(*count == 3);
+	return 0;
+}
+
+int streams(const char *prog)
+{
+	using namespace argparse;
+	std::stringstream ss;
+	Parser p("streams", '-', ss);
+	Flag<int> scale(p, "scale", "a scale", 1);
+	Arg<custom_namespace::Total> total(p, "values", "values to add");
+	Flag<custom_namespace::Copied> copied(p, "copied", "a copied name", {});
+	{
+		std::string data("--scale\n2\n");
+		for (int i=1; i<=1000; ++i) { data += std::to_string(i) + '\n'; }
+		std::FILE *f = std::tmpfile();
+		std::fwrite(data.data(), 1, data.size(), f);
+		std::rewind(f);
+		Stream stream(f, '\n', 16);
+		auto result = p.parse(stream, prog);
+		assert(result.code == result.success);
+		assert(*scale == 2);
+		assert(total->sum == 500500);
+		assert(total->count == 1000);
+		std::fclose(f);
+	}
+	p.reset();
+	{
+		//reading the next token does not move the value being parsed
+		std::FILE *f = std::tmpfile();
+		std::fwrite("--copied\0" "abcdefghij\0" "12345678", 1, 28, f);
+		std::rewind(f);
+		Stream stream(f, '\0', 4);
+		auto result = p.parse(stream, prog);
+		assert(result.code == result.success);
+		assert(copied->text == "abcdefghij");
+		assert(total->sum == 12345678);
+		std::fclose(f);
+	}
+	p.reset();
+	{
+		std::FILE *f = std::tmpfile();
+		std::fwrite("5\0-h", 1, 4, f);
+		std::rewind(f);
+		Stream stream(f);
+		assert(p.parse(stream, prog).code == ParseResult::help);
+		std::fclose(f);
+	}
+	p.reset();
+	{
+		ss.str("");
+		std::FILE *f = std::tmpfile();
+		std::fwrite("--nope\0" "1\0-h", 1, 11, f);
+		std::rewind(f);
+		Stream stream(f);
+		auto result = p.parse(stream, prog);
+		assert(result.code == result.unknown);
+		assert(ss.str() == "Unknown flag \"--nope\"\n");
+		std::fclose(f);
+	}
+	p.reset();
+	{
+		//the value read after the flag overwrites its token
+		ss.str("");
+		std::FILE *f = std::tmpfile();
+		std::fwrite("--sc\0" "xyzw", 1, 9, f);
+		std::rewind(f);
+		Stream stream(f, '\0', 4);
+		p.abbreviate = true;
+		auto result = p.parse(stream, prog);
+		p.abbreviate = false;
+		assert(result.code == result.error);
+		assert(!std::strcmp(result.failure.name, "scale"));
+		std::fclose(f);
+	}
+	p.reset();
+	{
+		Stream stream(-1);
+		auto result = p.parse(stream, prog);
+		assert(stream.error());
+		assert(result.code == result.error);
+		assert(result.failure.kind == ParseResult::Error::bad_stream);
+		assert(!result.failure.name);
+	}
+	return 0;
+}
+
+int environment(const char *prog)
+{
+	using namespace argparse;
+	std::stringstream ss;
+	Parser p("environment", '-', ss);
+	Flag<int> threads(p, {"t", "threads"}, "thread count", 1);
+	Flag<const char*> name(p, "name", "a name", "none");
+	Flag<float, 3> vec(p, "vec", "a vector", {0, 0, 0});
+	Flag<bool, 0> verbose(p, "v", "verbose");
+	Flag<int> req(p, "req", "required");
+	p.env(threads, "ARGPARSE_TEST_THREADS");
+	p.env(name, "ARGPARSE_TEST_NAME");
+	p.env(vec, "ARGPARSE_TEST_VEC");
+	p.env(verbose, "ARGPARSE_TEST_VERBOSE");
+	p.env(req, "ARGPARSE_TEST_REQ");
+	try
+	{
+		p.env(req, "ARGPARSE_TEST_NAME");
+		assert(0);
+	}
+	catch (std::logic_error&) {}
+	setenv("ARGPARSE_TEST_THREADS", "8", 1);
+	setenv("ARGPARSE_TEST_NAME", "-from env", 1);
+	setenv("ARGPARSE_TEST_VEC", "1 2 '3'", 1);
+	setenv("ARGPARSE_TEST_VERBOSE", "0", 1);
+	setenv("ARGPARSE_TEST_REQ", "5", 1);
+	{
+		const char *args[] = {"-t", "3"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.success);
+		assert(*threads == 3);
+		assert(result.parsed(threads) == ParseResult::commandline);
+		assert(!std::strcmp(*name, "-from env"));
+		assert(result.parsed(name) == ParseResult::environment);
+		assert(vec[0] == 1 && vec[1] == 2 && vec[2] == 3);
+		assert(result.parsed(vec) == ParseResult::environment);
+		assert(!*verbose);
+		assert(!result.parsed(verbose));
+		assert(*req == 5);
+	}
+	p.reset();
+	setenv("ARGPARSE_TEST_VERBOSE", "1", 1);
+	unsetenv("ARGPARSE_TEST_REQ");
+	{
+		const char *args[] = {"--req", "1"};
+		Values values(p);
+		auto result = p.parse(args, values, prog);
+		assert(result.code == result.success);
+		assert(values[threads] == 8);
+		assert(values[verbose]);
+		assert(*threads == 1);
+	}
+	{
+		const char *args[] = {"--help"};
+		assert(p.parse(args, prog).code == ParseResult::help);
+		assert(ss.str().find(
+			"[-t | --threads] Default: 1 Env: ARGPARSE_TEST_THREADS\n")
+			!= std::string::npos);
+	}
+	{
+		ss.str("");
+		setenv("ARGPARSE_TEST_THREADS", "eight", 1);
+		const char *args[] = {"--req", "1"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.error);
+		assert(result.failure.kind == ParseResult::Error::bad_environment);
+		assert(result.failure.arg == &threads);
+		assert(ss.str()
+			== "Error parsing environment variable \"ARGPARSE_TEST_THREADS\"\n");
+	}
+	unsetenv("ARGPARSE_TEST_THREADS");
+	unsetenv("ARGPARSE_TEST_NAME");
+	unsetenv("ARGPARSE_TEST_VEC");
+	unsetenv("ARGPARSE_TEST_VERBOSE");
+	{
+		//a remainder flag's values outlive the parse
+		Parser rp("remainder");
+		Flag<const char*, -2> rest(rp, "rest", "remaining args");
+		rp.env(rest, "ARGPARSE_TEST_REST");
+		setenv("ARGPARSE_TEST_REST", "a 'b c' d", 1);
+		const char *args[] = {"--rest"};
+		auto result = rp.parse(0, args, prog);
+		unsetenv("ARGPARSE_TEST_REST");
+		assert(result.code == result.success);
+		assert(result.parsed(rest) == ParseResult::environment);
+		ArgIter it = *rest;
+		assert(!std::strcmp(it.arg, "a"));
+		it.step();
+		assert(!std::strcmp(it.arg, "b c"));
+		it.step();
+		assert(!std::strcmp(it.arg, "d"));
+		it.step();
+		assert(!it);
+	}
+	//names set directly are checked when frozen
+	req.env = "ARGPARSE_TEST_NAME";
+	try
+	{
+		p.freeze();
+		assert(0);
+	}
+	catch (std::logic_error&) {}
+	req.env = "ARGPARSE_TEST_REQ";
+	p.freeze();
+	return 0;
+}
+
+int configfile(const char *prog)
+{
+	using namespace argparse;
+	std::stringstream ss;
+	Parser p("config", '-', ss);
+	Flag<int> threads(p, {"t", "threads"}, "thread count", 1);
+	Flag<const char*> name(p, "name", "a name", "none");
+	Flag<float, 3> vec(p, "vec", "a vector", {0, 0, 0});
+	Flag<int, -1> list(p, "list", "a list", {});
+	Flag<bool, 0> verbose(p, "v", "verbose");
+	Flag<int> level(p, "level", "a level", 0);
+	p.env(level, "ARGPARSE_TEST_LEVEL");
+	p.config = "argparse_test.conf";
+	std::ofstream(p.config)
+		<< "# defaults\n"
+		<< "\n"
+		<< "threads = 4\r\n"
+		<< "  name=some name  \n"
+		<< "vec = 1 '2' \"3\"\n"
+		<< "list =\n"
+		<< "v = true\n"
+		<< "level = 7\n"
+		<< "threads = 5";
+	setenv("ARGPARSE_TEST_LEVEL", "2", 1);
+	{
+		const char *args[] = {"--name", "arg"};
+		auto result = p.parse(args, prog);
+		assert(result.code == result.success);
+		assert(*threads == 4);
+		assert(result.parsed(threads) == ParseResult::configfile);
+		assert(!std::strcmp(*name, "arg"));
+		assert(result.parsed(name) == ParseResult::commandline);
+		assert(vec[0] == 1 && vec[1] == 2 && vec[2] == 3);
+		assert(list->empty());
+		assert(result.parsed(list) == ParseResult::configfile);
+		assert(*verbose);
+		assert(*level == 2);
+		assert(result.parsed(level) == ParseResult::environment);
+	}
+	unsetenv("ARGPARSE_TEST_LEVEL");
+	p.reset();
+	ParseResult kept;
+	{
+		const char *args[] = {"-v"};
+		kept = p.parse(args, prog);
+	}
+	assert(kept.code == ParseResult::success);
+	assert(!std::strcmp(*name, "some name"));
+	assert(*verbose);
+	assert(*level == 7);
+	{
+		//an unchanged file is read once and shared
+		const char *args[] = {"-v"};
+		Values values(p);
+		auto result = p.parse(args, values, prog);
+		assert(result.code == result.success);
+		assert(values[name] == *name);
+	}
+
+	const char **noargs = nullptr;
+	std::ofstream(p.config) << "threads = 4\n\nthreads2 = 1\n";
+	{
+		auto result = p.parse(0, noargs, prog);
+		assert(result.code == result.error);
+		assert(result.failure.kind == ParseResult::Error::bad_config);
+		assert(result.failure.index == 3);
+		assert(!result.failure.arg);
+		assert(result.failure.message()
+			== "Error in config file \"argparse_test.conf\", line 3");
+	}
+	std::ofstream(p.config) << "vec = 1 2\n";
+	{
+		auto result = p.parse(0, noargs, prog);
+		assert(result.code == result.error);
+		assert(result.failure.index == 1);
+		assert(result.failure.arg == &vec);
+	}
+	//a same-size edit within the same second is read again
+	std::ofstream(p.config) << "threads = 6\n";
+	{
+		Values values(p);
+		auto result = p.parse(0, noargs, values, prog);
+		assert(result.code == result.success);
+		assert(values[threads] == 6);
+	}
+	std::ofstream(p.config) << "level = 777\n";
+	{
+		Values values(p);
+		auto result = p.parse(0, noargs, values, prog);
+		assert(result.code == result.success);
+		assert(values[threads] == 1);
+		assert(values[level] == 777);
+	}
+	p.config = "argparse_missing.conf";
+	{
+		auto result = p.parse(0, noargs, prog);
+		assert(result.code == result.error);
+		assert(result.failure.index == 0);
+		assert(result.failure.message()
+			== "Error in config file \"argparse_missing.conf\"");
+	}
+	return 0;
+}
+
 int main(int argc, char *argv[])
 {
 	return (
@@ -266,5 +1164,17 @@ int main(int argc, char *argv[])
 		|| repeat_flag(argv[0])
 		|| repeat_arg(argv[0])
 		|| full(argv[0])
+		|| singlepass(argv[0])
+		|| many(argv[0])
+		|| reuse(argv[0])
+		|| clusters(argv[0])
+		|| help(argv[0])
+		|| failures(argv[0])
+		|| subcommands(argv[0])
+		|| abbreviations(argv[0])
+		|| responsefiles(argv[0])
+		|| streams(argv[0])
+		|| environment(argv[0])
+		|| configfile(argv[0])
 	);
 }
@@ -0,0 +1,91 @@
+#undef NDEBUG
+#include "argparse/argparse.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+	using namespace argparse;
+	Parser p("batch");
+	Arg<int> num(p, "num", "A number");
+	Flag<double, -1> coords(p, "coords", "coordinates", {});
+	Flag<bool> verbose(p, "v", "verbosity");
+	Aflag<const char*> tags(p, "tag", "tags", {"none"});
+
+	std::vector<std::string> storage;
+	const std::size_t count = 5000;
+	storage.reserve(count);
+	std::vector<std::vector<const char*>> rows;
+	for (std::size_t i=0; i<count; ++i)
+	{
+		storage.push_back(std::to_string(i));
+		const char *n = storage.back().c_str();
+		switch (i % 4)
+		{
+			case 0: rows.push_back({n, "-vv", "--coords", n, "1.5"}); break;
+			case 1: rows.push_back({n, "--tag", "a", "--tag", "b"}); break;
+			case 2: rows.push_back({"--coords", "x"}); break;
+			case 3: rows.push_back({"-h"}); break;
+		}
+	}
+
+	for (unsigned threads : {1u, 4u, 0u})
+	{
+		Batch batch = p.parse_batch(rows, threads);
+		assert(batch.size() == count);
+		auto nums = batch.column(num);
+		auto cs = batch.column(coords);
+		auto vs = batch.column(verbose);
+		auto ts = batch.column(tags);
+		assert(nums.size() == count);
+		for (std::size_t i=0; i<count; ++i)
+		{
+			switch (i % 4)
+			{
+				case 0:
+					assert(batch.codes[i] == ParseResult::success);
+					assert(nums[i] == static_cast<int>(i));
+					assert(cs[i].size() == 2);
+					assert(cs[i][0] == static_cast<double>(i));
+					assert(cs[i][1] == 1.5);
+					assert(vs[i] == 2);
+					assert(ts[i].size() == 1 && !std::strcmp(ts[i][0], "none"));
+					assert(batch.parsed(coords, i));
+					assert(!batch.parsed(tags, i));
+					break;
+				case 1:
+					assert(batch.codes[i] == ParseResult::success);
+					assert(batch.failures[i].kind == ParseResult::Error::none);
+					assert(batch(num, i) == static_cast<int>(i));
+					assert(cs[i].empty());
+					assert(vs[i] == 0);
+					assert(ts[i].size() == 2 && !std::strcmp(ts[i][1], "b"));
+					assert(batch.parsed(tags, i));
+					assert(!batch.parsed(coords, i));
+					break;
+				case 2:
+					assert(batch.codes[i] == ParseResult::error);
+					assert(
+						batch.failures[i].kind == ParseResult::Error::bad_positional);
+					assert(batch.failures[i].arg == &num);
+					assert(batch.failures[i].index == 1);
+					break;
+				case 3:
+					assert(batch.codes[i] == ParseResult::help);
+					break;
+			}
+		}
+	}
+
+	//args themselves are untouched
+	assert(coords->empty());
+	assert(tags->size() == 1);
+
+	Batch empty = p.parse_batch(nullptr, 0);
+	assert(!empty.size());
+	assert(!empty.column(num).size());
+	return 0;
+}
@@ -0,0 +1,41 @@
+#undef NDEBUG
+#include "argparse/bitset.hpp"
+
+#include <cassert>
+
+int main(int argc, char *argv[])
+{
+	for (std::size_t size : {0, 1, 64, 65, 128, 129, 1000})
+	{
+		argparse::BitSet bits(size);
+		assert(bits.size() == size);
+		assert(!bits.any());
+		for (std::size_t i=0; i<size; i+=3) { bits.set(i); }
+		for (std::size_t i=0; i<size; ++i) { assert(bits.test(i) == !(i%3)); }
+		assert(!bits.test(size));
+		assert(bits.any() == (size > 0));
+
+		argparse::BitSet copy(bits);
+		for (std::size_t i=0; i<size; i+=3) { bits.reset(i); }
+		assert(!bits.any());
+		for (std::size_t i=0; i<size; ++i) { assert(copy.test(i) == !(i%3)); }
+		copy.clear();
+		assert(!copy.any());
+	}
+
+	{
+		argparse::BitSet mask(200), bits(200);
+		assert(bits.contains(mask));
+		mask.set(3);
+		mask.set(150);
+		assert(!bits.contains(mask));
+		bits.set(3);
+		assert(!bits.contains(mask));
+		bits.set(150);
+		bits.set(7);
+		assert(bits.contains(mask));
+		assert(!mask.contains(bits));
+		assert(bits.contains(argparse::BitSet()));
+	}
+	return 0;
+}
@@ -0,0 +1,105 @@
+#undef NDEBUG
+#include "argparse/bktree.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+	typedef argparse::BKTree BKTree;
+	assert(BKTree::distance("", 0, "", 0) == 0);
+	assert(BKTree::distance("abc", 3, "", 0) == 3);
+	assert(BKTree::distance("kitten", 6, "sitting", 7) == 3);
+	assert(BKTree::distance("verbose", 7, "verbos", 6) == 1);
+	assert(BKTree::distance("flaw", 4, "lawn", 4) == 2);
+	{
+		std::string a(100, 'a');
+		std::string b(90, 'a');
+		assert(BKTree::distance(a.c_str(), a.size(), b.c_str(), b.size()) == 10);
+	}
+
+	const char *out[3];
+	{
+		BKTree tree;
+		assert(!tree.nearest("anything", 2, out, 3));
+		tree.build({});
+		assert(!tree.size());
+		assert(!tree.nearest("anything", 2, out, 3));
+	}
+	{
+		BKTree tree;
+		tree.build({"verbose", "version", "value", "help", "output", "outfile"});
+		assert(tree.size() == 6);
+		assert(tree.nearest("verbos", 2, out, 3) == 1);
+		assert(!std::strcmp(out[0], "verbose"));
+		assert(tree.nearest("versoin", 2, out, 3) == 1);
+		assert(!std::strcmp(out[0], "version"));
+		assert(tree.nearest("hlep", 2, out, 3) == 1);
+		assert(!std::strcmp(out[0], "help"));
+		assert(tree.nearest("outfil", 3, out, 3) == 2);
+		assert(!std::strcmp(out[0], "outfile"));
+		assert(!std::strcmp(out[1], "output"));
+		assert(tree.nearest("outfil", 3, out, 1) == 1);
+		assert(!std::strcmp(out[0], "outfile"));
+		assert(!tree.nearest("zzzzzz", 2, out, 3));
+	}
+	{
+		//aliases of one id are returned once, as the closest of them
+		BKTree tree;
+		tree.build({"verbose", "verbos", "version", "vers"}, {0, 0, 1, 1});
+		assert(tree.nearest("verbse", 2, out, 3) == 2);
+		assert(!std::strcmp(out[0], "verbose"));
+		assert(!std::strcmp(out[1], "vers"));
+		assert(tree.nearest("verbo", 2, out, 3) == 2);
+		assert(!std::strcmp(out[0], "verbos"));
+		assert(!std::strcmp(out[1], "vers"));
+	}
+	{
+		//more results than fit the local buffer
+		BKTree tree;
+		tree.build({"ab", "ac", "ad", "ae", "af", "ag", "ah", "ai", "aj", "ak"});
+		const char *many[10];
+		assert(tree.nearest("az", 1, many, 10) == 10);
+		assert(!std::strcmp(many[0], "ab") && !std::strcmp(many[9], "ak"));
+	}
+	{
+		//compare against a linear scan
+		std::vector<std::string> storage;
+		for (int i=0; i<500; ++i)
+		{ storage.push_back("opt" + std::to_string(i * 7919 % 1000)); }
+		std::vector<const char*> names;
+		for (auto &name : storage) { names.push_back(name.c_str()); }
+		BKTree tree;
+		tree.build(names);
+		const char *queries[] = {"opt12", "opt1x3", "pot99", "opt", "o"};
+		for (const char *q : queries)
+		{
+			std::size_t best = static_cast<std::size_t>(-1);
+			for (const char *name : names)
+			{
+				std::size_t d = BKTree::distance(
+					q, std::strlen(q), name, std::strlen(name));
+				if (d < best) { best = d; }
+			}
+			std::size_t n = tree.nearest(q, 2, out, 1);
+			const char *all[20];
+			std::size_t total = 0;
+			for (const char *name : names)
+			{
+				total += BKTree::distance(
+					q, std::strlen(q), name, std::strlen(name)) <= 2;
+			}
+			assert(tree.nearest(q, 2, all, 20) == std::min<std::size_t>(total, 20));
+			assert(n == (best <= 2));
+			if (n)
+			{
+				assert(BKTree::distance(
+					q, std::strlen(q), out[0], std::strlen(out[0])) == best);
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,60 @@
+// Compare store() for doubles with strtod.
+// usage: floatbench [count]
+#include "argparse/nums.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	template<class F>
+	double seconds(F &&f)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+	std::mt19937_64 gen(1);
+	std::uniform_real_distribution<double> coords(-180, 180);
+	std::vector<std::string> args;
+	args.reserve(count);
+	char buf[64];
+	for (std::size_t i=0; i<count; ++i)
+	{
+		std::snprintf(buf, sizeof(buf), "%.*g", static_cast<int>(i % 17 + 1), coords(gen));
+		args.push_back(buf);
+	}
+	double total = 0;
+	double check = 0;
+	for (int round=0; round<3; ++round)
+	{
+		double store = seconds([&]()
+		{
+			for (const std::string &arg : args)
+			{
+				double d;
+				argparse::store(d, arg.c_str());
+				total += d;
+			}
+		});
+		double strtod = seconds([&]()
+		{
+			for (const std::string &arg : args)
+			{ check += std::strtod(arg.c_str(), nullptr); }
+		});
+		std::printf(
+			"store: %.1f ns/arg  strtod: %.1f ns/arg  (%.2fx)\n",
+			store * 1e9 / count, strtod * 1e9 / count, strtod / store);
+	}
+	return total != check;
+}
@@ -1,6 +1,128 @@
+#undef NDEBUG
 #include "argparse/nums.hpp"
 
 #include <cassert>
+#include <cctype>
+#include <clocale>
+#include <cstdint>
+#include <cstdio>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+
+namespace
+{
+	//store() as it was with strtol.
+	template<class W>
+	bool reference(W &dst, const char *arg, int base)
+	{
+		char *end = nullptr;
+		errno = 0;
+		if (std::is_signed<W>::value)
+		{ dst = static_cast<W>(std::strtoll(arg, &end, base)); }
+		else
+		{ dst = static_cast<W>(std::strtoull(arg, &end, base)); }
+		if ((errno == ERANGE) || (!dst && end == arg)) { return false; }
+		while (std::isspace(*end)) { ++end; }
+		return !*end;
+	}
+
+	template<class T, class W>
+	void compare(const char *arg, int base)
+	{
+		W wide;
+		bool expect = reference(wide, arg, base)
+			&& wide >= std::numeric_limits<T>::min()
+			&& wide <= std::numeric_limits<T>::max();
+		T val = 0;
+		bool got = argparse::store(val, arg, base);
+		assert(got == expect);
+		if (got) { assert(val == static_cast<T>(wide)); }
+	}
+
+	//store() as it was with strtod/strtof, in the C locale.
+	template<class T>
+	bool freference(T &dst, const char *arg)
+	{
+		char *end = nullptr;
+		errno = 0;
+		if (sizeof(T) == sizeof(float)) { dst = std::strtof(arg, &end); }
+		else { dst = std::strtod(arg, &end); }
+		if (
+			(dst && dst == std::numeric_limits<T>::infinity() && errno == ERANGE)
+			|| (!dst && end == arg))
+		{ return false; }
+		while (std::isspace(*end)) { ++end; }
+		return !*end;
+	}
+
+	template<class T>
+	void fcompare(const char *arg)
+	{
+		T expect = 0, got = 0;
+		bool ok = freference(expect, arg);
+		assert(argparse::store(got, arg) == ok);
+		if (ok)
+		{
+			assert(
+				(got != got && expect != expect)
+				|| !std::memcmp(&got, &expect, sizeof(T)));
+		}
+	}
+
+	void fcompareall(const char *arg)
+	{
+		fcompare<float>(arg);
+		fcompare<double>(arg);
+	}
+
+	//Base<T, base> agrees with the runtime base.
+	template<int base, class T>
+	void rcompare(const char *arg)
+	{
+		T expect = 0;
+		argparse::Base<T, base> got{0};
+		bool ok = argparse::store(expect, arg, base);
+		assert(argparse::store(got, arg) == ok);
+		if (ok) { assert(got.data == expect); }
+	}
+
+	template<class T>
+	void rcompareall(const char *arg)
+	{
+		rcompare<2, T>(arg);
+		rcompare<4, T>(arg);
+		rcompare<8, T>(arg);
+		rcompare<16, T>(arg);
+		rcompare<32, T>(arg);
+	}
+
+	void compareall(const char *arg)
+	{
+		rcompareall<short>(arg);
+		rcompareall<int>(arg);
+		rcompareall<long long>(arg);
+		rcompareall<unsigned int>(arg);
+		rcompareall<unsigned long long>(arg);
+		for (int base : {0, 2, 8, 10, 16, 36})
+		{
+			compare<short, long long>(arg, base);
+			compare<int, long long>(arg, base);
+			compare<long, long long>(arg, base);
+			compare<long long, long long>(arg, base);
+			compare<unsigned short, unsigned long long>(arg, base);
+			compare<unsigned int, unsigned long long>(arg, base);
+			compare<unsigned long long, unsigned long long>(arg, base);
+			if (sizeof(long) == sizeof(long long))
+			{ compare<unsigned long, unsigned long long>(arg, base); }
+		}
+	}
+}
 
 int main(int argc, char *argv[])
 {
@@ -31,6 +153,36 @@ int main(int argc, char *argv[])
 		assert(val == val);
 	}
 
+	{
+		argparse::Base<int, 0> val;
+		assert(argparse::store(val, "0x1F") && val == 31);
+		assert(argparse::store(val, " -0o17 ") && val == -15);
+		assert(argparse::store(val, "+0B101") && val == 5);
+		assert(argparse::store(val, "017") && val == 15);
+		assert(argparse::store(val, "-010") && val == -8);
+		assert(argparse::store(val, "0") && val == 0);
+		assert(argparse::store(val, "17") && val == 17);
+		assert(!argparse::store(val, "09"));
+		assert(argparse::store(val, "-0x80000000") && val == INT_MIN);
+		assert(!argparse::store(val, "0x80000000"));
+		assert(!argparse::store(val, "0b102"));
+		assert(!argparse::store(val, "0o8"));
+		assert(!argparse::store(val, "0x"));
+		assert(!argparse::store(val, "0b"));
+		assert(!argparse::store(val, "0x-1"));
+		argparse::Base<unsigned long long, 0> big;
+		assert(
+			argparse::store(
+				big, "0b1111111111111111111111111111111111111111111111111111111111111111")
+			&& big == ULLONG_MAX);
+		assert(
+			!argparse::store(
+				big, "0b10000000000000000000000000000000000000000000000000000000000000000"));
+		assert(argparse::store(big, "0xffffffffffffffff") && big == ULLONG_MAX);
+		argparse::Base<double, 0> d;
+		assert(argparse::store(d, "1.5") && d == 1.5);
+	}
+
 	{
 		argparse::Base<short, 10> val{3};
 		assert(val == 3);
@@ -45,6 +197,118 @@ int main(int argc, char *argv[])
 		assert(val < 10);
 	}
 
+	for (const char *arg : {
+		"", "-", "+", "0", "-0", "+7", "0x", "0x1f", "0X1F", " 0xg", "017",
+		"08", "0b1", "32767", "32768", "-32768", "-32769", "65535", "65536",
+		"2147483647", "2147483648", "-2147483648", "-2147483649",
+		"4294967295", "4294967296", "-4294967295", "-1",
+		"9223372036854775807", "9223372036854775808",
+		"-9223372036854775808", "-9223372036854775809",
+		"18446744073709551615", "18446744073709551616",
+		"-18446744073709551615", "-18446744073709551616",
+		"00000000000000000000000000000001", "123456781234567812345678",
+		"12345678", "1234567 ", "12345678\t", "1234567x", "\v\f 42 \r\n",
+		"zz", "ZZ", "-zZ", "7fffffffffffffff", "ffffffffffffffff"})
+	{ compareall(arg); }
+
+	{
+		std::mt19937 gen(7);
+		const char chars[] = " \t+-0123456789abfxX";
+		for (int i=0; i<100000; ++i)
+		{
+			std::string arg;
+			int size = gen() % 24;
+			bool digits = gen() % 2;
+			for (int j=0; j<size; ++j)
+			{
+				arg += digits && j
+					? static_cast<char>('0' + gen() % 10)
+					: chars[gen() % (sizeof(chars) - 1)];
+			}
+			compareall(arg.c_str());
+		}
+	}
+
+	{
+		//digits ending right before a page boundary
+		alignas(4096) static char pages[8192];
+		for (int size=1; size<24; ++size)
+		{
+			char *arg = pages + 4096 - size - 1;
+			std::memset(arg, '9', size);
+			arg[size] = '\0';
+			compareall(arg);
+			arg[0] = '-';
+			compareall(arg);
+		}
+	}
+
+	for (const char *arg : {
+		"0", "-0", "+0.0", "1", "-1", "0.5", ".5", "5.", ".", "-.", "e5", "1e",
+		"1e+", "1e5", "1E-5", " 1.5 ", "1.5x", "inf", "-Infinity", "infinit",
+		"nan", "NaN(123_abc)", "nan(", "0x1.8p3", "-0X.8P-1", "0x", "0x1p",
+		"0xg", "1e308", "1.8e308", "-1.8e308", "1e-400", "4.9406564584124654e-324",
+		"2.4703282292062328e-324", "2.4703282292062327e-324",
+		"2.2250738585072011e-308", "2.2250738585072014e-308",
+		"1.7976931348623157e308", "1.7976931348623158e308",
+		"1.7976931348623159e308", "3.4028235e38", "3.4028236e38", "1e39",
+		"1.4e-45", "7e-46", "9007199254740993", "9007199254740993.0000000001",
+		"1e23", "8.589973e9", "16777217", "16777217.000000000000000000001",
+		"0.1000000000000000055511151231257827021181583404541015625",
+		"0.1000000000000000055511151231257827021181583404541015624",
+		"0.1000000000000000055511151231257827021181583404541015626",
+		"000000000000000000000000000000000000001.5e-10",
+		"123456789012345678901234567890e-20",
+		"0.000000000000000000000000000000000000000000001",
+		"1e99999999999", "1e-99999999999"})
+	{ fcompareall(arg); }
+	{
+		//long mantissas out of range without a large exponent
+		std::string above("17976931348623158079");
+		above.append(290, '0');
+		std::string hexabove("0x");
+		hexabove.append(300, 'f');
+		std::string below("0.");
+		below.append(400, '0');
+		below += "12345678901234567890123";
+		for (const std::string &arg : {
+			above, above + "e-1", above + ".5e-1", "0." + above + "e310",
+			hexabove, hexabove + "p-1", below, below + "e+10",
+			"-" + above + "e-1"})
+		{ fcompareall(arg.c_str()); }
+	}
+
+	if (std::setlocale(LC_NUMERIC, "de_DE.UTF-8"))
+	{
+		//, is the decimal point for strtod but not for store
+		double d;
+		assert(argparse::store(d, "0.5") && d == 0.5);
+		assert(!argparse::store(d, "0,5"));
+		std::setlocale(LC_NUMERIC, "C");
+	}
+
+	{
+		std::mt19937_64 gen(11);
+		char buf[64];
+		for (int i=0; i<200000; ++i)
+		{
+			std::uint64_t bits = gen();
+			double d;
+			std::memcpy(&d, &bits, sizeof(d));
+			std::snprintf(buf, sizeof(buf), "%.*g", static_cast<int>(gen() % 18 + 1), d);
+			fcompareall(buf);
+			float f;
+			std::uint32_t fbits = static_cast<std::uint32_t>(bits);
+			std::memcpy(&f, &fbits, sizeof(f));
+			std::snprintf(buf, sizeof(buf), "%.*g", static_cast<int>(gen() % 10 + 1), f);
+			fcompareall(buf);
+			//long digit strings near halfway points
+			std::string digits = std::to_string(gen()) + std::to_string(gen());
+			digits.insert(gen() % digits.size(), ".");
+			digits += "e" + std::to_string(static_cast<int>(gen() % 700) - 350);
+			fcompareall(digits.c_str());
+		}
+	}
 
 	return 0;
 }
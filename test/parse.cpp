@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 int main(int argc, char *argv[])
 {
@@ -79,5 +80,35 @@ int main(int argc, char *argv[])
 	assert(result);
 	assert(!std::strcmp(c, "hello.txt"));
 
+	{
+		const char *args[] = {
+			"-n5", "6", "7", "x", "8", "--0", "9", "--1", "-10", "-f"};
+		argparse::ArgIter it(args, "-");
+		it.stepflag();
+		std::vector<int> v;
+		assert(argparse::parse(v, it) == 2);
+		assert((v == std::vector<int>{5, 6, 7}));
+		//reserved for the args up to the breakpoint
+		assert(v.capacity() == 5);
+		assert(!std::strcmp(it.arg, "x"));
+		it.step();
+		std::vector<double> d{1.5};
+		assert(argparse::parse(d, it) == 1);
+		assert((d == std::vector<double>{8}));
+		assert(!std::strcmp(it.arg, "9"));
+		assert(argparse::parse(v, it) == 2);
+		assert((v == std::vector<int>{9, -10}));
+		assert(it.isflag == 1);
+		assert(!std::strcmp(it.arg, "f"));
+	}
+	{
+		const char *args[] = {"1", "2", "--0", "3", "--0", "--0", "4"};
+		argparse::ArgIter it(args, "-");
+		std::vector<std::vector<int>> v;
+		assert(argparse::parse(v, it) == 1);
+		assert((v == std::vector<std::vector<int>>{{1, 2}, {3}}));
+		assert(!std::strcmp(it.arg, "4"));
+	}
+
 	return 0;
 }
@@ -0,0 +1,185 @@
+#undef NDEBUG
+#include "argparse/rangelist.hpp"
+#include "argparse/argparse.hpp"
+
+#include <cassert>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	typedef argparse::RangeList::value_type value_type;
+
+	std::string str(const argparse::RangeList &list)
+	{
+		std::stringstream ss;
+		ss << list;
+		return ss.str();
+	}
+
+	std::vector<value_type> values(const argparse::RangeList &list)
+	{ return std::vector<value_type>(list.begin(), list.end()); }
+
+	//Ranges are disjoint, sorted and hold exactly the values in expect.
+	void check(const argparse::RangeList &list, const std::set<value_type> &expect)
+	{
+		const auto &ranges = list.intervals();
+		for (std::size_t i=0; i<ranges.size(); ++i)
+		{
+			assert(ranges[i].step);
+			assert((ranges[i].last - ranges[i].first) % ranges[i].step == 0);
+			if (i) { assert(ranges[i-1].last < ranges[i].first); }
+		}
+		assert(values(list) == std::vector<value_type>(expect.begin(), expect.end()));
+		assert(list.count() == expect.size());
+		for (value_type v=0; v<80; ++v)
+		{ assert(list.contains(v) == !!expect.count(v)); }
+		argparse::RangeList back;
+		assert(argparse::store(back, str(list).c_str()));
+		assert(values(back) == values(list));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	{
+		argparse::RangeList list;
+		assert(list.empty() && list.count() == 0 && str(list) == "");
+		assert(list.begin() == list.end());
+		assert(argparse::store(list, "1-1000000,2000-2100:5"));
+		assert(str(list) == "1-1000000");
+		assert(list.count() == 1000000);
+		assert(list.contains(1) && list.contains(1000000));
+		assert(!list.contains(0) && !list.contains(1000001));
+
+		assert(argparse::store(list, " 7,0-3,2000-2100:5,5 "));
+		assert(str(list) == "0-3,5,7,2000-2100:5");
+		assert(list.count() == 4 + 2 + 21);
+		assert(list.contains(2005) && !list.contains(2006));
+		assert(list.contains(2100) && !list.contains(2105));
+		auto it = list.begin();
+		for (int i=0; i<6; ++i) { ++it; }
+		assert(*it == 2000);
+		assert(*++it == 2005);
+
+		//last is moved onto the step, touching ranges merge
+		assert(argparse::store(list, "1-10:4,4-6,7-8"));
+		assert(str(list) == "1,4-9");
+		assert(argparse::store(list, "0-10:2,12-20:2"));
+		assert(str(list) == "0-20:2");
+		assert(argparse::store(list, "0-100:2,10-20:4,50"));
+		assert(str(list) == "0-100:2");
+		assert(argparse::store(list, "0-18446744073709551615"));
+		assert(list.count() == ~0ull);
+		assert(list.contains(~0ull));
+
+		//interleaved grids are listed where they overlap
+		assert(argparse::store(list, "0-9:2,0-9:3"));
+		assert(str(list) == "0,2-4,6,8-9");
+		assert(argparse::store(list, "0-9:2,1-9:2"));
+		assert(str(list) == "0-9");
+		assert(argparse::store(list, "0-100:10,5-30:5"));
+		assert(str(list) == "0,5-30:5,40-100:10");
+		assert(argparse::store(list, "0-30:3,10-70:4"));
+		std::set<value_type> expect;
+		for (value_type v=0; v<=30; v+=3) { expect.insert(v); }
+		for (value_type v=10; v<=70; v+=4) { expect.insert(v); }
+		check(list, expect);
+		assert(argparse::store(
+			list, "18446744073709551605-18446744073709551615:2,"
+			"18446744073709551605-18446744073709551615:3"));
+		assert(list.contains(~0ull) && list.contains(~0ull - 1));
+		assert(list.count() == 8);
+
+		assert(argparse::store(list, "3,9-12"));
+		argparse::RangeList kept(list);
+		for (const char *bad : {
+			"", " ", ",", "1,", ",1", "1,,2", "-1", "1-", "1-:2", "5-1", "1-9:0",
+			"1:2", "1 - 2", "1, 2", "a", "18446744073709551616",
+			"0-1000000:2,1-1000000:3"})
+		{
+			assert(!argparse::store(list, bad));
+			assert(values(list) == values(kept));
+		}
+	}
+	{
+		argparse::RangeList list("1-3,6");
+		argparse::BitSet bits;
+		assert(list.bitmask(bits));
+		assert(bits.size() == 7);
+		for (std::size_t i=0; i<7; ++i)
+		{ assert(bits.test(i) == ((i >= 1 && i <= 3) || i == 6)); }
+		assert(!list.bitmask(bits, 6));
+		assert(bits.size() == 7);
+
+		bool threw = false;
+		try { argparse::RangeList bad("1-"); }
+		catch (std::logic_error&) { threw = true; }
+		assert(threw);
+		try
+		{
+			argparse::RangeList dense("0-1000000:2,1-1000000:3");
+			assert(false);
+		}
+		catch (std::logic_error &e)
+		{ assert(std::string(e.what()).find("overlaps") != std::string::npos); }
+	}
+	{
+		//random overlapping lists against a set of their values
+		std::mt19937 gen(5);
+		for (int i=0; i<20000; ++i)
+		{
+			std::string spec;
+			std::set<value_type> expect;
+			int items = gen() % 5 + 1;
+			for (int j=0; j<items; ++j)
+			{
+				value_type first = gen() % 60;
+				value_type last = first + gen() % 20;
+				value_type step = gen() % 3 ? 1 : gen() % 6 + 1;
+				if (j) { spec += ','; }
+				spec += std::to_string(first);
+				if (gen() % 4)
+				{
+					spec += '-' + std::to_string(last);
+					if (step != 1 || gen() % 2) { spec += ':' + std::to_string(step); }
+					for (value_type v=first; v<=last; v+=step) { expect.insert(v); }
+				}
+				else
+				{ expect.insert(first); }
+			}
+			argparse::RangeList list;
+			assert(argparse::store(list, spec.c_str()));
+			check(list, expect);
+		}
+	}
+	{
+		using namespace argparse;
+		std::stringstream ss;
+		Parser p("ranges", '-', ss);
+		Flag<RangeList> cpus(p, "cpus", "CPU ids", RangeList("0-3"));
+		Arg<RangeList, -1> shards(p, "shards", "Shard ids");
+		{
+			const char *args[] = {"--help"};
+			assert(p.parse(args, "prog").code == ParseResult::help);
+			assert(ss.str().find("[--cpus] Default: 0-3") != std::string::npos);
+		}
+		{
+			const char *args[] = {"--cpus", "8-15:2", "1-1000000", "7"};
+			assert(p.parse(args, "prog").code == ParseResult::success);
+			assert(str(*cpus) == "8-14:2");
+			assert(shards->size() == 2);
+			assert((*shards)[0].count() == 1000000);
+			assert((*shards)[1].contains(7));
+		}
+		{
+			const char *args[] = {"--cpus", "8-"};
+			assert(p.parse(args, "prog").code == ParseResult::error);
+		}
+	}
+	return 0;
+}
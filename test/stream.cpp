@@ -0,0 +1,101 @@
+#undef NDEBUG
+#include "argparse/stream.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+	std::FILE* input(const std::string &data)
+	{
+		std::FILE *f = std::tmpfile();
+		std::fwrite(data.data(), 1, data.size(), f);
+		std::rewind(f);
+		return f;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	using argparse::Stream;
+	{
+		//capacity smaller than the tokens forces moves and growth
+		std::string data("a\0bcdefghij\0\0klm\0last", 22);
+		for (std::size_t capacity : {1, 3, 4, 64})
+		{
+			std::FILE *f = input(data);
+			Stream s(f, '\0', capacity);
+			assert(!std::strcmp(s.next(), "a"));
+			assert(!std::strcmp(s.next(), "bcdefghij"));
+			assert(!std::strcmp(s.next(), ""));
+			assert(!std::strcmp(s.next(), "klm"));
+			assert(!std::strcmp(s.next(), "last"));
+			assert(!s.next());
+			assert(!s.next());
+			std::fclose(f);
+		}
+	}
+	{
+		std::FILE *f = input("one\ntwo words\n");
+		Stream s(fileno(f), '\n', 4);
+		assert(!std::strcmp(s.next(), "one"));
+		assert(!std::strcmp(s.next(), "two words"));
+		assert(!s.next());
+		std::fclose(f);
+	}
+	{
+		std::FILE *f = input("");
+		Stream s(f);
+		assert(!s.next());
+		std::fclose(f);
+	}
+	{
+		//many tokens through a small buffer
+		std::string data;
+		for (int i=0; i<10000; ++i) { data += std::to_string(i) + '\n'; }
+		std::FILE *f = input(data);
+		Stream s(f, '\n', 16);
+		int count = 0;
+		while (const char *token = s.next())
+		{ assert(std::to_string(count++) == token); }
+		assert(count == 10000);
+		std::fclose(f);
+	}
+	{
+		//the previous token survives reading the next one
+		std::string data;
+		for (int i=0; i<1000; ++i) { data += std::string(i % 7 + 1, 'a' + i % 26) + '\n'; }
+		for (std::size_t capacity : {1, 5, 16})
+		{
+			std::FILE *f = input(data);
+			Stream s(f, '\n', capacity);
+			const char *previous = s.next();
+			std::string expect = previous;
+			while (const char *token = s.next())
+			{
+				assert(previous == expect);
+				previous = token;
+				expect = token;
+			}
+			assert(previous == expect);
+			std::fclose(f);
+		}
+	}
+	{
+		std::FILE *f = input(std::string("a\0b", 3));
+		Stream s(f);
+		assert(!std::strcmp(s.next(), "a"));
+		assert(!std::strcmp(s.next(), "b"));
+		assert(!s.next());
+		assert(!s.error());
+		std::fclose(f);
+
+		//read errors end the input
+		Stream bad(-1);
+		assert(!bad.next());
+		assert(bad.error());
+	}
+	return 0;
+}
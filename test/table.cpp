@@ -0,0 +1,44 @@
+#undef NDEBUG
+#include "argparse/table.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+	{
+		argparse::NameTable table;
+		assert(table.find("anything") == table.npos);
+		assert(table.find("", 0) == table.npos);
+		table.build({});
+		assert(!table.size());
+		assert(table.find("anything") == table.npos);
+	}
+
+	{
+		std::vector<std::string> storage;
+		for (int i=0; i<1000; ++i)
+		{ storage.push_back("flag" + std::to_string(i)); }
+		for (char c='a'; c<='z'; ++c)
+		{ storage.push_back(std::string(1, c)); }
+		std::vector<const char*> names;
+		for (auto &name : storage) { names.push_back(name.c_str()); }
+
+		argparse::NameTable table;
+		table.build(names);
+		assert(table.size() == names.size());
+		for (std::size_t i=0; i<names.size(); ++i)
+		{
+			assert(table.find(names[i]) == i);
+			assert(table.find(names[i], std::strlen(names[i])) == i);
+		}
+		assert(table.find("flag") == table.npos);
+		assert(table.find("flag1000") == table.npos);
+		assert(table.find("flag10", 5) == table.find("flag1"));
+		assert(table.find("ab") == table.npos);
+		assert(table.find("") == table.npos);
+	}
+	return 0;
+}
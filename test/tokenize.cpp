@@ -0,0 +1,99 @@
+#undef NDEBUG
+#include "argparse/tokenize.hpp"
+#include "argparse/argparse.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+	//Tokenize a copy of line.
+	std::vector<std::string> split(const std::string &line, int *count=nullptr)
+	{
+		std::vector<char> buf(line.begin(), line.end());
+		buf.push_back('\0');
+		const char *argv[64];
+		int n = argparse::tokenize(buf.data(), argv);
+		if (count) { *count = n; }
+		std::vector<std::string> ret;
+		for (int i=0; i<n && i<64; ++i)
+		{
+			assert(argv[i] >= buf.data() && argv[i] < buf.data() + buf.size());
+			ret.push_back(argv[i]);
+		}
+		return ret;
+	}
+
+	typedef std::vector<std::string> Strs;
+}
+
+int main(int argc, char *argv[])
+{
+	assert(split("") == Strs{});
+	assert(split(" \t\n ") == Strs{});
+	assert((split("tool --threads 8 -v 'some path'")
+		== Strs{"tool", "--threads", "8", "-v", "some path"}));
+	assert((split("  a\t\tb\nc  ") == Strs{"a", "b", "c"}));
+	assert((split("a\\ b c\\\\d \\'e") == Strs{"a b", "c\\d", "'e"}));
+	assert((split("'' \"\" x''y") == Strs{"", "", "xy"}));
+	assert((split("'a \\ \"b\"' \"c \\\" \\\\ \\$ \\` \\x 'd'\"")
+		== Strs{"a \\ \"b\"", "c \" \\ $ ` \\x 'd'"}));
+	assert((split("con\\\ntinued \"in\\\nside\"") == Strs{"continued", "inside"}));
+	assert((split("pre'fix 'mid\"dle \"post") == Strs{"prefix middle post"}));
+	assert(split("trailing\\") == Strs{"trailing\\"});
+
+	int count;
+	split("'open", &count);
+	assert(count == -1);
+	split("\"open\\\"", &count);
+	assert(count == -1);
+
+	//long runs go through the vector scanner, specials at every offset
+	for (std::size_t pos=0; pos<40; ++pos)
+	{
+		std::string word(40, 'w');
+		std::string quoted(word);
+		quoted.insert(pos, "\\ ");
+		std::string expect(word);
+		expect.insert(pos, " ");
+		assert((split(quoted + " " + word) == Strs{expect, word}));
+		std::string dq = "\"" + word + "\"";
+		dq.insert(pos + 1, "\\\"");
+		expect = word;
+		expect.insert(pos, "\"");
+		assert((split(dq + "\t" + word) == Strs{expect, word}));
+		std::string spaced(word);
+		spaced[pos] = pos % 2 ? '\r' : '\v';
+		Strs parts;
+		if (pos) { parts.push_back(word.substr(0, pos)); }
+		if (pos < 39) { parts.push_back(word.substr(pos+1)); }
+		assert(split(spaced) == parts);
+	}
+
+	{
+		//more args than capacity
+		char line[] = "a b c d";
+		const char *args[2];
+		assert(argparse::tokenize(line, args) == 4);
+		assert(!std::strcmp(args[1], "b"));
+		assert(!std::strcmp(args[1] + 2, "c"));
+	}
+	{
+		using namespace argparse;
+		Parser p("tokenized");
+		Flag<int> threads(p, "threads", "thread count", 1);
+		Flag<bool, 0> verbose(p, "v", "verbose");
+		Arg<const char*> path(p, "path", "a path");
+		char line[] = "--threads 8 -v 'some path'";
+		const char *args[8];
+		int n = tokenize(line, args);
+		assert(n == 4);
+		assert(p.parse(n, args, "tool").code == ParseResult::success);
+		assert(*threads == 8);
+		assert(*verbose);
+		assert(!std::strcmp(*path, "some path"));
+	}
+	return 0;
+}
@@ -0,0 +1,70 @@
+#undef NDEBUG
+#include "argparse/trie.hpp"
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+	typedef argparse::PrefixTrie PrefixTrie;
+	{
+		PrefixTrie trie;
+		assert(trie.find("anything") == trie.npos);
+		trie.build({}, {});
+		assert(trie.find("anything") == trie.npos);
+		assert(trie.find("") == trie.npos);
+	}
+
+	{
+		PrefixTrie trie;
+		trie.build(
+			{"verbose", "v", "version", "value", "help", "ver", "x"},
+			{0, 0, 1, 2, 3, 4, 5});
+		assert(trie.find("verbose") == 0);
+		assert(trie.find("verb") == 0);
+		assert(trie.find("version") == 1);
+		assert(trie.find("versi") == 1);
+		assert(trie.find("vers") == 1);
+		assert(trie.find("ver") == trie.ambiguous);
+		assert(trie.find("v") == trie.ambiguous);
+		assert(trie.find("va") == 2);
+		assert(trie.find("h") == 3);
+		assert(trie.find("x") == 5);
+		assert(trie.find("verbosely") == trie.npos);
+		assert(trie.find("help", 2) == 3);
+		assert(trie.find("q") == trie.npos);
+		assert(trie.find("") == trie.npos);
+	}
+
+	{
+		//same value through every branch
+		PrefixTrie trie;
+		trie.build({"color", "colour"}, {7, 7});
+		assert(trie.find("col") == 7);
+		assert(trie.find("colo") == 7);
+		assert(trie.find("colou") == 7);
+	}
+
+	{
+		std::vector<std::string> storage;
+		for (int i=0; i<1000; ++i)
+		{ storage.push_back("flag" + std::to_string(i)); }
+		std::vector<const char*> names;
+		std::vector<std::size_t> values;
+		for (std::size_t i=0; i<storage.size(); ++i)
+		{
+			names.push_back(storage[i].c_str());
+			values.push_back(i);
+		}
+		PrefixTrie trie;
+		trie.build(names, values);
+		for (std::size_t i=0; i<names.size(); ++i)
+		{ assert(trie.find(names[i]) == (i && i < 100 ? trie.ambiguous : i)); }
+		assert(trie.find("flag99") == trie.ambiguous);
+		assert(trie.find("flag999") == 999);
+		assert(trie.find("flag") == trie.ambiguous);
+		assert(trie.find("flagx") == trie.npos);
+	}
+	return 0;
+}
@@ -0,0 +1,143 @@
+#undef NDEBUG
+#include "argparse/units.hpp"
+#include "argparse/argparse.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	template<class T>
+	std::string str(const T &value)
+	{
+		std::stringstream ss;
+		ss << value;
+		return ss.str();
+	}
+
+	//value prints as text, which parses back to value
+	template<class T>
+	void roundtrip(const T &value, const char *text)
+	{
+		assert(str(value) == text);
+		T back{};
+		assert(argparse::store(back, text));
+		assert(*back == *value);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	using namespace std::chrono;
+	{
+		argparse::Size s{};
+		assert(argparse::store(s, "0") && s == 0);
+		assert(argparse::store(s, "512") && s == 512);
+		assert(argparse::store(s, "512B") && s == 512);
+		assert(argparse::store(s, " 4k ") && s == 4096);
+		assert(argparse::store(s, "512M") && s == 512ull << 20);
+		assert(argparse::store(s, "512MiB") && s == 512ull << 20);
+		assert(argparse::store(s, "512MB") && s == 512000000ull);
+		assert(argparse::store(s, "2G") && s == 2ull << 30);
+		assert(argparse::store(s, "15E") && s == 15ull << 60);
+		assert(argparse::store(s, "18446744073709551615") && s == ~0ull);
+		assert(!argparse::store(s, "16E"));
+		assert(!argparse::store(s, "18446744073709551616"));
+		assert(!argparse::store(s, "19EB"));
+		assert(!argparse::store(s, ""));
+		assert(!argparse::store(s, "M"));
+		assert(!argparse::store(s, "-1"));
+		assert(!argparse::store(s, "1.5G"));
+		assert(!argparse::store(s, "1 G"));
+		assert(!argparse::store(s, "1X"));
+		assert(!argparse::store(s, "1Mi"));
+		assert(!argparse::store(s, "1MIB"));
+		assert(!argparse::store(s, "1b"));
+
+		roundtrip(argparse::Size{0}, "0");
+		roundtrip(argparse::Size{1536}, "1536");
+		roundtrip(argparse::Size{3ull << 19}, "1536K");
+		roundtrip(argparse::Size{512ull << 20}, "512M");
+		roundtrip(argparse::Size{1ull << 62}, "4E");
+		roundtrip(argparse::Size{1000000}, "1000000");
+	}
+	{
+		argparse::Duration d{};
+		assert(argparse::store(d, "250ms") && *d == milliseconds(250));
+		assert(argparse::store(d, "5") && *d == seconds(5));
+		assert(argparse::store(d, "5s") && *d == seconds(5));
+		assert(argparse::store(d, "\t90m ") && *d == minutes(90));
+		assert(argparse::store(d, "2h") && *d == hours(2));
+		assert(argparse::store(d, "3d") && *d == hours(72));
+		assert(argparse::store(d, "7us") && *d == microseconds(7));
+		assert(argparse::store(d, "7ns") && *d == nanoseconds(7));
+		assert(argparse::store(d, "9223372036854775807ns"));
+		assert(!argparse::store(d, "9223372036854775808ns"));
+		assert(!argparse::store(d, "106752d"));
+		assert(!argparse::store(d, "1.5s"));
+		assert(!argparse::store(d, "ms"));
+		assert(!argparse::store(d, "5 ms"));
+		assert(!argparse::store(d, "5sec"));
+		assert(!argparse::store(d, "5S"));
+		assert(argparse::store(d, "-5s") && *d == seconds(-5));
+		assert(argparse::store(d, " -0") && *d == seconds(0));
+		assert(argparse::store(d, "-9223372036854775808ns")
+			&& *d == nanoseconds::min());
+		assert(!argparse::store(d, "-9223372036854775809ns"));
+		assert(!argparse::store(d, "- 5s"));
+		assert(!argparse::store(d, "--5s"));
+		assert(!argparse::store(d, "+5s"));
+
+		roundtrip(argparse::Duration{nanoseconds(0)}, "0s");
+		roundtrip(argparse::Duration{milliseconds(250)}, "250ms");
+		roundtrip(argparse::Duration{seconds(90)}, "90s");
+		roundtrip(argparse::Duration{minutes(90)}, "90m");
+		roundtrip(argparse::Duration{hours(48)}, "2d");
+		roundtrip(argparse::Duration{nanoseconds(1001)}, "1001ns");
+		roundtrip(argparse::Duration{milliseconds(-3)}, "-3ms");
+		roundtrip(argparse::Duration{nanoseconds::min()}, "-9223372036854775808ns");
+	}
+	{
+		using namespace argparse;
+		std::stringstream ss;
+		Parser p("units", '-', ss);
+		Flag<Size> cache(p, "cache", "Cache size", Size{64ull << 20});
+		Flag<Duration> timeout(
+			p, "timeout", "Timeout", Duration{milliseconds(1500)});
+		Flag<Duration> offset(p, "offset", "Offset", Duration{seconds(-2)});
+		Arg<Duration, -1> waits(p, "waits", "Waits");
+		{
+			const char *args[] = {"--help"};
+			assert(p.parse(args, "prog").code == ParseResult::help);
+			std::string help = ss.str();
+			assert(help.find("[--cache] Default: 64M") != std::string::npos);
+			assert(help.find("[--timeout] Default: 1500ms") != std::string::npos);
+			assert(help.find("[--offset] Default: -2s") != std::string::npos);
+		}
+		{
+			//the printed default is accepted as a value
+			const char *args[] = {"--offset", "--1", "-2s", "1s"};
+			ParseResult result = p.parse(args, "prog");
+			assert(result.code == ParseResult::success);
+			assert(result.parsed(offset));
+			assert(**offset == seconds(-2));
+		}
+		{
+			const char *args[] = {"--cache", "1G", "1s", "20ms", "3"};
+			ParseResult result = p.parse(args, "prog");
+			assert(result.code == ParseResult::success);
+			assert(**cache == 1ull << 30);
+			assert(**timeout == milliseconds(1500));
+			assert(waits->size() == 3);
+			assert(*(*waits)[1] == milliseconds(20));
+			assert(*(*waits)[2] == seconds(3));
+		}
+		{
+			const char *args[] = {"--timeout", "1x", "1s"};
+			assert(p.parse(args, "prog").code == ParseResult::error);
+		}
+	}
+	return 0;
+}
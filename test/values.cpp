@@ -0,0 +1,197 @@
+#undef NDEBUG
+#include "argparse/argparse.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Count allocations that reach the upstream of an arena.
+struct Counting: public std::pmr::memory_resource
+{
+	int count = 0;
+
+	void* do_allocate(std::size_t bytes, std::size_t align) override
+	{
+		++count;
+		return std::pmr::new_delete_resource()->allocate(bytes, align);
+	}
+	void do_deallocate(void *p, std::size_t bytes, std::size_t align) override
+	{ std::pmr::new_delete_resource()->deallocate(p, bytes, align); }
+	bool do_is_equal(const std::pmr::memory_resource &o) const noexcept override
+	{ return this == &o; }
+};
+
+int main(int argc, char *argv[])
+{
+	using namespace argparse;
+	std::stringstream ss;
+	Parser p("values", '-', ss);
+	Arg<int> num(p, "num", "A number");
+	Arg<float, 2> point(p, "point", "x y", {1, 2});
+	Flag<long, -1> nums(p, "nums", "numbers", {{1, 2}});
+	Flag<bool, 0> toggle(p, "t", "toggle");
+	Flag<bool> count(p, "c", "count", 1);
+	Aflag<int> appended(p, "a", "appended", {7});
+	Flag<const char*> name(p, "name", "a name", "default");
+
+	{
+		Values values(p);
+		assert(values[point][1] == 2);
+		assert(values[nums].size() == 2);
+		assert(values[count] == 1);
+		assert(values[appended].size() == 1 && values[appended][0] == 7);
+		assert(!std::strcmp(values[name], "default"));
+
+		const char *args[] = {
+			"5", "3", "4", "--nums", "6", "7", "8", "-tccc", "-a1", "-a2",
+			"--name", "bob"};
+		auto result = p.parse(args, values, argv[0]);
+		assert(result.code == result.success);
+		assert(result.parsed(num));
+		assert(result.parsed(point));
+		assert(result.parsed(name));
+		assert(values[num] == 5);
+		assert(values[point][0] == 3 && values[point][1] == 4);
+		assert(values[nums].size() == 3 && values[nums][2] == 8);
+		assert(values[toggle]);
+		assert(values[count] == 4);
+		assert(values[appended].size() == 2 && values[appended][1] == 2);
+		assert(!std::strcmp(values[name], "bob"));
+
+		//args themselves are untouched
+		assert(point[0] == 1);
+		assert(nums->size() == 2);
+		assert(!*toggle);
+		assert(*count == 1);
+		assert(appended->size() == 1);
+		assert(!std::strcmp(*name, "default"));
+
+		//reused values start from defaults
+		const char *args2[] = {"9", "-a3"};
+		result = p.parse(args2, values, argv[0]);
+		assert(result.code == result.success);
+		assert(values[num] == 9);
+		assert(values[point][0] == 1);
+		assert(values[nums].size() == 2);
+		assert(!values[toggle]);
+		assert(values[count] == 1);
+		assert(values[appended].size() == 1 && values[appended][0] == 3);
+
+		const char *bad[] = {"x"};
+		result = p.parse(bad, values, argv[0]);
+		assert(result.code == result.error);
+		//nothing is printed when parsing into values
+		assert(!result.failure.message().empty());
+		const char *help[] = {"--help"};
+		result = p.parse(help, values, argv[0]);
+		assert(result.code == result.help);
+		assert(ss.str().empty());
+		p.help(ss, "prog", false);
+		assert(ss.str().compare(0, 12, "Usage: prog ") == 0);
+		ss.str("");
+
+		Parser other("other");
+		Flag<int> foreign(other, "nums", "not in p", 0);
+		try
+		{
+			values[foreign];
+			assert(false);
+		}
+		catch (std::logic_error&)
+		{}
+		try
+		{
+			Values othervalues(other);
+			p.parse(args2, othervalues, argv[0]);
+			assert(false);
+		}
+		catch (std::logic_error&)
+		{}
+	}
+
+	{
+		//in place and into values give the same occurrences
+		Parser ap("paths");
+		Aflag<bool> counts(ap, "v", "counts");
+		const char *args[] = {"-vvv", "-v"};
+		Values values(ap);
+		assert(ap.parse(args, values, argv[0]).code == ParseResult::success);
+		assert(ap.parse(args, argv[0]).code == ParseResult::success);
+		const std::vector<int> expect{1, 2, 3, 4};
+		assert(*counts == expect);
+		assert(std::equal(
+			values[counts].begin(), values[counts].end(),
+			expect.begin(), expect.end()));
+	}
+
+	{
+		p.freeze();
+		std::vector<std::thread> threads;
+		std::vector<int> ok(8, 0);
+		for (int t=0; t<8; ++t)
+		{
+			threads.emplace_back([&, t]()
+			{
+				Values values(p);
+				bool good = true;
+				for (int i=0; i<2000; ++i)
+				{
+					std::string n = std::to_string(t * 10000 + i);
+					const char *args[] = {n.c_str(), "--nums", n.c_str(), "-cc"};
+					auto result = p.parse(args, values, "thread");
+					good = good && result.code == result.success
+						&& values[num] == t * 10000 + i
+						&& values[nums].size() == 1
+						&& values[nums][0] == t * 10000 + i
+						&& values[count] == 3;
+				}
+				ok[t] = good;
+			});
+		}
+		for (auto &thread : threads) { thread.join(); }
+		for (int good : ok) { assert(good); }
+	}
+
+	{
+		Parser ap("arena");
+		Flag<int, -1> many(ap, "many", "many ints", {{1}});
+		Aflag<int, -1> lists(ap, "l", "lists");
+		std::vector<std::string> storage;
+		std::vector<const char*> args{"--many"};
+		for (int i=0; i<1000; ++i) { storage.push_back(std::to_string(i)); }
+		for (auto &s : storage) { args.push_back(s.c_str()); }
+		for (int i=0; i<100; ++i)
+		{
+			args.push_back("-l");
+			args.push_back(storage[i].c_str());
+			args.push_back(storage[i+1].c_str());
+		}
+
+		Counting upstream;
+		std::pmr::monotonic_buffer_resource arena(&upstream);
+		{
+			Values values(ap, &arena);
+			assert(values[many].size() == 1 && values[many][0] == 1);
+			auto result = ap.parse(
+				static_cast<int>(args.size()), args.data(), values, "arena");
+			assert(result.code == result.success);
+			assert(values[many].size() == 1000 && values[many][999] == 999);
+			assert(values[lists].size() == 100);
+			assert(values[lists][99].size() == 2 && values[lists][99][1] == 100);
+			assert(values[many].get_allocator().resource() == &arena);
+			assert(values[lists].get_allocator().resource() == &arena);
+			assert(values[lists][0].get_allocator().resource() == &arena);
+			//1100+ vectors and their growth in a few blocks
+			assert(upstream.count && upstream.count < 20);
+		}
+		//args are untouched and still use the heap
+		assert(many->size() == 1);
+		assert(lists->empty());
+	}
+	return 0;
+}